@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "libminisat.a"
+  "libminisat.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/minisat.LIB.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/minisat.dir/simp/Main.cc.o"
+  "CMakeFiles/minisat.dir/simp/Main.cc.o.d"
+  "minisat"
+  "minisat.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/minisat.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
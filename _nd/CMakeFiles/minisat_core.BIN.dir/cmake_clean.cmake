@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/minisat_core.BIN.dir/core/Main.cc.o"
+  "CMakeFiles/minisat_core.BIN.dir/core/Main.cc.o.d"
+  "minisat_core"
+  "minisat_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/minisat_core.BIN.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,38 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_nd
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(6s120_f2 "/root/repo/_nd/minisat" "/root/repo/6s120_f2.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s120_f2 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;74;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s102_f7 "/root/repo/_nd/minisat" "/root/repo/6s102_f7.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s102_f7 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;75;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s102_f8 "/root/repo/_nd/minisat" "/root/repo/6s102_f8.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s102_f8 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;76;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s102_f8_1 "/root/repo/_nd/minisat" "/root/repo/6s102_f8_1.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s102_f8_1 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;77;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s102_f9 "/root/repo/_nd/minisat" "/root/repo/6s102_f9.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s102_f9 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;78;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s10_f1 "/root/repo/_nd/minisat" "/root/repo/6s10_f1.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s10_f1 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;79;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s10_f2 "/root/repo/_nd/minisat" "/root/repo/6s10_f2.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s10_f2 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;80;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s10_f3 "/root/repo/_nd/minisat" "/root/repo/6s10_f3.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s10_f3 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;81;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s10_f4 "/root/repo/_nd/minisat" "/root/repo/6s10_f4.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s10_f4 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;82;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s10_f5 "/root/repo/_nd/minisat" "/root/repo/6s10_f5.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s10_f5 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;83;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s10_f6 "/root/repo/_nd/minisat" "/root/repo/6s10_f6.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s10_f6 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;84;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(6s10_f7 "/root/repo/_nd/minisat" "/root/repo/6s10_f7.cnf" "-tcpf=/dev/null")
+set_tests_properties(6s10_f7 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;85;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(intel024_f7 "/root/repo/_nd/minisat" "/root/repo/intel024_f7.cnf" "-tcpf=/dev/null")
+set_tests_properties(intel024_f7 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;86;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+add_test(intel024_f22 "/root/repo/_nd/minisat" "/root/repo/intel024_f22.cnf" "-tcpf=/dev/null")
+set_tests_properties(intel024_f22 PROPERTIES  PASS_REGULAR_EXPRESSION "Replay SUCCESS" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;66;add_test;/root/repo/CMakeLists.txt;87;add_cnf_test;/root/repo/CMakeLists.txt;0;")
+subdirs("utils")
+subdirs("core")
+subdirs("simp")
+subdirs("mtl")
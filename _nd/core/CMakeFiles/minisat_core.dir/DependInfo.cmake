@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/core/Aig.cc" "core/CMakeFiles/minisat_core.dir/Aig.cc.o" "gcc" "core/CMakeFiles/minisat_core.dir/Aig.cc.o.d"
+  "/root/repo/core/InterpolantVisitor.cc" "core/CMakeFiles/minisat_core.dir/InterpolantVisitor.cc.o" "gcc" "core/CMakeFiles/minisat_core.dir/InterpolantVisitor.cc.o.d"
+  "/root/repo/core/LemmaChecker.cc" "core/CMakeFiles/minisat_core.dir/LemmaChecker.cc.o" "gcc" "core/CMakeFiles/minisat_core.dir/LemmaChecker.cc.o.d"
+  "/root/repo/core/Solver.cc" "core/CMakeFiles/minisat_core.dir/Solver.cc.o" "gcc" "core/CMakeFiles/minisat_core.dir/Solver.cc.o.d"
+  "/root/repo/core/TraceProofVisitor.cc" "core/CMakeFiles/minisat_core.dir/TraceProofVisitor.cc.o" "gcc" "core/CMakeFiles/minisat_core.dir/TraceProofVisitor.cc.o.d"
+  "/root/repo/core/TraceWriter.cc" "core/CMakeFiles/minisat_core.dir/TraceWriter.cc.o" "gcc" "core/CMakeFiles/minisat_core.dir/TraceWriter.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/minisat_core.dir/Aig.cc.o"
+  "CMakeFiles/minisat_core.dir/Aig.cc.o.d"
+  "CMakeFiles/minisat_core.dir/InterpolantVisitor.cc.o"
+  "CMakeFiles/minisat_core.dir/InterpolantVisitor.cc.o.d"
+  "CMakeFiles/minisat_core.dir/LemmaChecker.cc.o"
+  "CMakeFiles/minisat_core.dir/LemmaChecker.cc.o.d"
+  "CMakeFiles/minisat_core.dir/Solver.cc.o"
+  "CMakeFiles/minisat_core.dir/Solver.cc.o.d"
+  "CMakeFiles/minisat_core.dir/TraceProofVisitor.cc.o"
+  "CMakeFiles/minisat_core.dir/TraceProofVisitor.cc.o.d"
+  "CMakeFiles/minisat_core.dir/TraceWriter.cc.o"
+  "CMakeFiles/minisat_core.dir/TraceWriter.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/minisat_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/minisat_simp.dir/SimpSolver.cc.o"
+  "CMakeFiles/minisat_simp.dir/SimpSolver.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/minisat_simp.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
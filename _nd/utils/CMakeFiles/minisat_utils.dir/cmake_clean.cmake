@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/minisat_utils.dir/Options.cc.o"
+  "CMakeFiles/minisat_utils.dir/Options.cc.o.d"
+  "CMakeFiles/minisat_utils.dir/System.cc.o"
+  "CMakeFiles/minisat_utils.dir/System.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/minisat_utils.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,383 @@
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "utils/System.h"
+#include "utils/Options.h"
+#include "core/Dimacs.h"
+#include "core/Solver.h"
+#include "core/TraceProofVisitor.h"
+using namespace Minisat;
+
+//=================================================================================================
+// Benchmarks of the solver -- micro-benchmarks of unit propagation and conflict analysis, and
+// end-to-end runs of solving, validation, replay and trace output:
+//
+// Every benchmark runs in a process of its own, so that its peak memory is its own, and prints one
+// line of JSON with its counts, rates and per-phase CPU times. The generated instances are pinned
+// by their seeds, so that the output of two builds can be diffed.
+
+
+//=================================================================================================
+// Instances:
+
+
+// A random k-CNF, its clauses split evenly into 'parts' partitions in order:
+struct Generated {
+    const char* name;
+    int         vars;
+    int         clauses;
+    int         k;
+    int         parts;
+    uint64_t    seed;
+};
+
+// The micro-benchmark instances are a large one at the satisfiability threshold and smaller ones
+// far above it, on which random decisions soon run into conflicts. The macro-benchmark instances
+// are unsatisfiable and take a fraction of a second each to solve.
+static const Generated micro_instances[] = {
+    { "rand3-n1m",    1000000, 4260000, 3, 1, 1 },
+    { "rand3-n20k-r6",  20000,  120000, 3, 1, 2 },
+    { "rand4-n20k-r16", 20000,  320000, 4, 1, 3 },
+};
+static const Generated macro_instances[] = {
+    { "rand3-n160-p2",  160,  704, 3, 2, 21 },
+    { "rand3-n180-p2",  180,  774, 3, 2, 12 },
+    { "rand3-n200-p3",  200,  860, 3, 3, 13 },
+    { "rand3-n220-p4",  220,  946, 3, 4, 14 },
+    { "rand4-n80-p2",    80,  792, 4, 2, 15 },
+};
+
+
+static inline uint64_t nextRand(uint64_t& s) {
+    s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+
+
+template<class Solver>
+static void generate(const Generated& g, Solver& S)
+{
+    uint64_t s = g.seed * 0x9e3779b97f4a7c15ULL + 1;
+    vec<Lit> lits;
+    while (S.nVars() < g.vars) S.newVar();
+    for (int i = 0; i < g.clauses; i++){
+        S.setCurrentPart(1 + (uint64_t)i * g.parts / g.clauses);
+        lits.clear();
+        while (lits.size() < g.k){
+            Lit p = mkLit(nextRand(s) % g.vars, nextRand(s) & 1);
+            bool dup = false;
+            for (int j = 0; j < lits.size(); j++) dup |= var(lits[j]) == var(p);
+            if (!dup) lits.push(p); }
+        S.addClause_(lits);
+    }
+}
+
+
+// An instance is either generated or read from a file of the corpus:
+struct Instance {
+    std::string      name;
+    const Generated* gen;
+    std::string      file;
+};
+
+
+template<class Solver>
+static void load(const Instance& in, Solver& S)
+{
+    if (in.gen != NULL)
+        generate(*in.gen, S);
+    else{
+        gzFile f = gzopen(in.file.c_str(), "rb");
+        if (f == NULL) fprintf(stderr, "ERROR! Could not open file: %s\n", in.file.c_str()), exit(1);
+        parse_DIMACS(f, S);
+        gzclose(f); }
+}
+
+
+static void corpusFiles(const char* dir, std::vector<Instance>& out)
+{
+    DIR* d = opendir(dir);
+    if (d == NULL) fprintf(stderr, "ERROR! Could not open directory: %s\n", dir), exit(1);
+
+    std::vector<std::string> names;
+    for (struct dirent* e; (e = readdir(d)) != NULL;){
+        std::string n = e->d_name;
+        if ((n.size() > 4 && n.compare(n.size() - 4, 4, ".cnf") == 0) || (n.size() > 7 && n.compare(n.size() - 7, 7, ".cnf.gz") == 0))
+            names.push_back(n); }
+    closedir(d);
+
+    std::sort(names.begin(), names.end());
+    for (size_t i = 0; i < names.size(); i++){
+        Instance in = { names[i], NULL, std::string(dir) + "/" + names[i] };
+        out.push_back(in); }
+}
+
+
+//=================================================================================================
+// Results:
+
+
+// One line of JSON, written field by field:
+class Record {
+    std::string line;
+    void key(const char* k) { line += line.empty() ? "{" : ", "; line += "\""; line += k; line += "\": "; }
+ public:
+    void str (const char* k, const std::string& v) { key(k); line += "\"" + v + "\""; }
+    void num (const char* k, uint64_t v)           { char b[32]; snprintf(b, sizeof(b), "%" PRIu64, v); key(k); line += b; }
+    void real(const char* k, double v)             { char b[32]; snprintf(b, sizeof(b), "%.6g", v);     key(k); line += b; }
+    void print(FILE* out)                          { fprintf(out, "%s}\n", line.c_str()); fflush(out); }
+};
+
+
+static double wallTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+static uint64_t peakRSS() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss; }
+
+
+//=================================================================================================
+// Micro-benchmarks:
+//
+// Descend from the root by random decisions until a conflict or a full assignment and backtrack
+// to the root again, until a number of propagations is reached. 'bcp' only propagates, 'analyze'
+// also analyzes every conflict, without learning from it, so that both see the same decisions.
+
+
+class BenchSolver : public Solver {
+ public:
+    using Solver::newDecisionLevel;
+    using Solver::uncheckedEnqueue;
+    using Solver::propagate;
+    using Solver::analyze;
+    using Solver::cancelUntil;
+    using Solver::decisionLevel;
+};
+
+
+static void runMicro(const Instance& in, bool analyze, uint64_t props, Record& r)
+{
+    BenchSolver S;
+    S.proofLogging(false);
+    double t0 = cpuTime();
+    load(in, S);
+    double t_load = cpuTime() - t0;
+    if (!S.simplify()){
+        r.str("result", "UNSAT");
+        return; }
+
+    uint64_t s          = 12345;
+    uint64_t props0     = S.propagations;
+    vec<Var> order;
+    uint64_t descents   = 0;
+    uint64_t decisions  = 0;
+    uint64_t confls     = 0;
+    double   t_analyze  = 0;
+    vec<Lit> learnt;
+    Range    part;
+    int      bt;
+
+    // -- the decisions of a descent follow a random permutation of the variables from a random start
+    for (Var v = 0; v < S.nVars(); v++) order.push(v);
+    for (int i = order.size() - 1; i > 0; i--){
+        int j = nextRand(s) % (i + 1);
+        Var v = order[i]; order[i] = order[j]; order[j] = v; }
+
+    t0 = cpuTime();
+    while (S.propagations - props0 < props){
+        descents++;
+        int next = nextRand(s) % order.size();
+        for (;;){
+            Var v;
+            while (S.value(v = order[next]) != l_Undef) next = (next + 1) % order.size();
+            S.newDecisionLevel();
+            S.uncheckedEnqueue(mkLit(v, nextRand(s) & 1));
+            decisions++;
+
+            CRef confl = S.propagate();
+            if (confl != CRef_Undef){
+                confls++;
+                if (analyze){
+                    double a0 = wallTime();
+                    learnt.clear();
+                    S.analyze(confl, learnt, bt, part);
+                    t_analyze += wallTime() - a0; }
+                break; }
+            if (S.nAssigns() == S.nVars()) break;
+        }
+        S.cancelUntil(0);
+    }
+    double t_run = cpuTime() - t0;
+
+    r.num ("descents",             descents);
+    r.num ("decisions",            decisions);
+    r.num ("conflicts",            confls);
+    r.num ("propagations",         S.propagations - props0);
+    r.real("propagations_per_sec", (S.propagations - props0) / t_run);
+    if (analyze){
+        r.real("analyze_per_sec",   confls / t_analyze);
+        r.real("time_analyze",      t_analyze); }
+    r.real("time_load",            t_load);
+    r.real("time_run",             t_run);
+}
+
+
+//=================================================================================================
+// Macro-benchmarks:
+//
+// Solve with proof logging and, if the answer is UNSAT, validate the proof and replay it into a
+// trace in a temporary file.
+
+
+static void runMacro(const Instance& in, Record& r)
+{
+    Solver S;
+    double t0 = cpuTime();
+    load(in, S);
+    double t_load = cpuTime() - t0;
+    r.num("vars",    S.nVars());
+    r.num("clauses", S.nClauses());
+
+    t0 = cpuTime();
+    vec<Lit> dummy;
+    lbool ret = S.simplify() ? S.solveLimited(dummy) : l_False;
+    double t_solve = cpuTime() - t0;
+
+    r.str ("result",               ret == l_True ? "SAT" : ret == l_False ? "UNSAT" : "INDET");
+    r.num ("conflicts",            S.conflicts);
+    r.num ("propagations",         S.propagations);
+    r.real("conflicts_per_sec",    S.conflicts / t_solve);
+    r.real("propagations_per_sec", S.propagations / t_solve);
+    r.real("time_load",            t_load);
+    r.real("time_solve",           t_solve);
+
+    if (ret != l_False || !S.proofLogging()) return;
+
+    t0 = cpuTime();
+    bool valid = S.validate();
+    double t_validate = cpuTime() - t0;
+    r.real("time_validate", t_validate);
+    r.str ("valid",         valid ? "yes" : "no");
+    if (!valid) return;
+
+    FILE* tmp = tmpfile();
+    if (tmp == NULL) return;
+    t0 = cpuTime();
+    { TraceWriter w(tmp, false); TraceProofVisitor v(S, w); S.replay(v); }
+    double t_replay = cpuTime() - t0;
+    r.real("time_replay", t_replay);
+    r.real("time_total",  t_solve + t_validate + t_replay);
+    r.num ("trace_bytes", ftell(tmp));
+    fclose(tmp);
+}
+
+
+//=================================================================================================
+// Main:
+
+
+// Runs one benchmark in a child process, which prints its record. If the child does not finish,
+// its record only tells why.
+template<class Run>
+static void spawn(const char* suite, const char* bench, const Instance& in, int cpu_lim, FILE* out, Run run)
+{
+    fflush(out);
+    pid_t pid = fork();
+    if (pid < 0) fprintf(stderr, "ERROR! Could not fork: %s\n", strerror(errno)), exit(1);
+
+    if (pid == 0){
+        if (cpu_lim > 0){
+            struct rlimit rl = { (rlim_t)cpu_lim, (rlim_t)cpu_lim + 1 };
+            setrlimit(RLIMIT_CPU, &rl); }
+        Record r;
+        r.str("suite", suite); r.str("bench", bench); r.str("instance", in.name);
+        run(in, r);
+        r.num("peak_rss_kb", peakRSS());
+        r.print(out);
+        _exit(0);
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) return;
+
+    Record r;
+    r.str("suite", suite); r.str("bench", bench); r.str("instance", in.name);
+    r.str("error", WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU ? "cpu-lim" :
+                   WIFSIGNALED(status) ? strsignal(WTERMSIG(status)) : "failed");
+    r.print(out);
+}
+
+
+int main(int argc, char** argv)
+{
+    try {
+        setUsageHelp("USAGE: %s [options]\n\n  Runs the benchmarks and prints one line of JSON per benchmark.\n");
+
+#if defined(__linux__)
+        fpu_control_t oldcw, newcw;
+        _FPU_GETCW(oldcw); newcw = (oldcw & ~_FPU_EXTENDED) | _FPU_DOUBLE; _FPU_SETCW(newcw);
+#endif
+        StringOption suite   ("BENCH", "suite",    "Benchmarks to run (micro, macro or all).", "all");
+        StringOption corpus  ("BENCH", "corpus",   "Directory whose *.cnf and *.cnf.gz files are benchmarked next to the generated instances.");
+        StringOption out_file("BENCH", "out",      "Append the results to this file instead of printing them.");
+        Int64Option  props   ("BENCH", "props",    "Number of propagations of each micro-benchmark.", 10000000, Int64Range(1, INT64_MAX));
+        IntOption    cpu_lim ("BENCH", "cpu-lim",  "Limit on the CPU time of each benchmark in seconds (0=none).", 300, IntRange(0, INT32_MAX));
+
+        parseOptions(argc, argv, true);
+
+        bool micro = strcmp(suite, "all") == 0 || strcmp(suite, "micro") == 0;
+        bool macro = strcmp(suite, "all") == 0 || strcmp(suite, "macro") == 0;
+        if (!micro && !macro)
+            fprintf(stderr, "ERROR! Unknown suite: %s\n", (const char*)suite), exit(1);
+
+        FILE* out = stdout;
+        if (out_file && (out = fopen(out_file, "a")) == NULL)
+            fprintf(stderr, "ERROR! Could not open file: %s\n", (const char*)out_file), exit(1);
+
+        std::vector<Instance> files;
+        if (corpus) corpusFiles(corpus, files);
+
+        if (micro){
+            std::vector<Instance> ins;
+            for (size_t i = 0; i < sizeof(micro_instances) / sizeof(micro_instances[0]); i++){
+                Instance in = { micro_instances[i].name, &micro_instances[i], "" };
+                ins.push_back(in); }
+            ins.insert(ins.end(), files.begin(), files.end());
+
+            uint64_t n = props;
+            for (size_t i = 0; i < ins.size(); i++){
+                spawn("micro", "bcp",     ins[i], cpu_lim, out, [n](const Instance& in, Record& r){ runMicro(in, false, n, r); });
+                spawn("micro", "analyze", ins[i], cpu_lim, out, [n](const Instance& in, Record& r){ runMicro(in, true,  n, r); }); }
+        }
+
+        if (macro){
+            std::vector<Instance> ins;
+            for (size_t i = 0; i < sizeof(macro_instances) / sizeof(macro_instances[0]); i++){
+                Instance in = { macro_instances[i].name, &macro_instances[i], "" };
+                ins.push_back(in); }
+            ins.insert(ins.end(), files.begin(), files.end());
+
+            for (size_t i = 0; i < ins.size(); i++)
+                spawn("macro", "solve", ins[i], cpu_lim, out, runMacro);
+        }
+
+        if (out != stdout) fclose(out);
+        return 0;
+    } catch (OutOfMemoryException&){
+        printf("===============================================================================\n");
+        printf("INDETERMINATE\n");
+        exit(0);
+    }
+}
@@ -0,0 +1,66 @@
+#include "Aig.h"
+
+namespace Minisat
+{
+  Aig::Aig () : m_ands (0)
+  {
+    Node c = { -1, -1 };
+    m_nodes.push (c);
+  }
+
+  int Aig::mkInput ()
+  {
+    Node n = { -1, -1 };
+    m_inputs.push (m_nodes.size ());
+    m_nodes.push (n);
+    return 2 * (m_nodes.size () - 1);
+  }
+
+  int Aig::mkAnd (int a, int b)
+  {
+    if (a > b) { int t = a; a = b; b = t; }
+
+    // -- constant propagation
+    if (a == False) return False;
+    if (a == True) return b;
+    if (a == b) return a;
+    if (a == neg (b)) return False;
+
+    // -- structural hashing
+    uint64_t key = (uint64_t) a << 32 | (uint32_t) b;
+    int res;
+    if (m_hash.peek (key, res)) return res;
+
+    Node n = { a, b };
+    m_nodes.push (n);
+    m_ands++;
+    res = 2 * (m_nodes.size () - 1);
+    m_hash.insert (key, res);
+    return res;
+  }
+
+  void Aig::writeAiger (FILE *out, const vec<int> &outputs) const
+  {
+    // -- AIGER wants the inputs before the and nodes, the and nodes
+    // -- are created after their fanins and keep their order
+    vec<int> idx (m_nodes.size (), 0);
+    int n = 0;
+    for (int i = 0; i < m_inputs.size (); ++i) idx [m_inputs [i]] = ++n;
+    for (int i = 1; i < m_nodes.size (); ++i)
+      if (m_nodes [i].a >= 0) idx [i] = ++n;
+
+    fprintf (out, "aag %d %d 0 %d %d\n", n, m_inputs.size (), outputs.size (), m_ands);
+    for (int i = 0; i < m_inputs.size (); ++i)
+      fprintf (out, "%d\n", 2 * idx [m_inputs [i]]);
+    for (int i = 0; i < outputs.size (); ++i)
+      fprintf (out, "%d\n", 2 * idx [node (outputs [i])] + (outputs [i] & 1));
+    for (int i = 1; i < m_nodes.size (); ++i)
+    {
+      const Node &nd = m_nodes [i];
+      if (nd.a < 0) continue;
+      fprintf (out, "%d %d %d\n", 2 * idx [i],
+               2 * idx [node (nd.a)] + (nd.a & 1),
+               2 * idx [node (nd.b)] + (nd.b & 1));
+    }
+  }
+}
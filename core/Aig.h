@@ -0,0 +1,54 @@
+#ifndef _AIG_H_
+#define _AIG_H_
+
+#include "mtl/Vec.h"
+#include "mtl/Map.h"
+
+#include <cstdio>
+
+namespace Minisat
+{
+  /// And-inverter graph with structural hashing and constant propagation.
+  ///
+  /// An edge is a literal '2*node + sign'. Node 0 is the constant, so the
+  /// literal 0 is false and 1 is true. An and node is only created if no
+  /// node with the same (ordered) fanins exists and no simplification of
+  /// 'a & 0', 'a & 1', 'a & a' or 'a & ~a' applies.
+  class Aig
+  {
+  protected:
+    struct Node { int a, b; };
+    struct AndHash
+    {
+      uint32_t operator() (uint64_t k) const
+      { return (uint32_t) (k >> 32) * 2654435761u ^ (uint32_t) k; }
+    };
+
+    /// -- fanins of each node, 'a < 0' for inputs and the constant
+    vec<Node> m_nodes;
+    vec<int> m_inputs;
+    int m_ands;
+    Map<uint64_t, int, AndHash> m_hash;
+
+  public:
+    enum { False = 0, True = 1 };
+
+    Aig ();
+
+    static int neg (int a) { return a ^ 1; }
+    static int node (int a) { return a >> 1; }
+
+    int mkInput ();
+    int mkAnd (int a, int b);
+    int mkOr (int a, int b) { return neg (mkAnd (neg (a), neg (b))); }
+
+    int nInputs () const { return m_inputs.size (); }
+    int nAnds () const { return m_ands; }
+    bool isInput (int a) const { return node (a) > 0 && m_nodes [node (a)].a < 0; }
+
+    /// -- writes the graph in ASCII AIGER format, with the given outputs.
+    /// -- Inputs are numbered in the order they were created.
+    void writeAiger (FILE *out, const vec<int> &outputs) const;
+  };
+}
+#endif
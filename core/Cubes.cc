@@ -0,0 +1,396 @@
+#include "core/Cubes.h"
+#include "core/TraceProofVisitor.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace Minisat;
+
+//=================================================================================================
+// Messages:
+
+
+static void writeLits(FILE* out, const vec<Lit>& lits)
+{
+    for (int i = 0; i < lits.size(); i++)
+        fprintf(out, " %s%d", sign(lits[i]) ? "-" : "", var(lits[i]) + 1);
+    fprintf(out, " 0\n");
+}
+
+
+static bool readLits(FILE* in, vec<Lit>& lits)
+{
+    lits.clear();
+    for (;;){
+        int x;
+        if (fscanf(in, "%d", &x) != 1) return false;
+        if (x == 0) return true;
+        lits.push(mkLit(abs(x) - 1, x < 0)); }
+}
+
+
+//=================================================================================================
+// Worker:
+
+
+static bool writeCubeProof(Solver& S, const char* dir, int id)
+{
+    if (!S.validate()){
+        fprintf(stderr, "ERROR! The proof of cube %d is not valid.\n", id);
+        return false; }
+
+    std::string file = std::string(dir) + "/cube-" + std::to_string(id) + ".trace";
+    FILE* out = fopen(file.c_str(), "w");
+    if (out == NULL){
+        fprintf(stderr, "ERROR! Could not open file: %s\n", file.c_str());
+        return false; }
+    { TraceWriter w(out, false); TraceProofVisitor v(S, w); S.replay(v); }
+    fclose(out);
+    return true;
+}
+
+
+int Minisat::serveCubes(const char* state, FILE* in, FILE* out, const char* proof_dir)
+{
+    Solver*  S = NULL;
+    vec<Lit> cube;
+    char     kind;
+    int      id;
+    int64_t  budget;
+
+    while (fscanf(in, " %c %d %" SCNd64, &kind, &id, &budget) == 3 && kind == 'c' && readLits(in, cube)){
+        // -- with proofs, every cube is refuted from a fresh copy of the snapshot, so that the proof is its own
+        if (S == NULL || (S->proofLogging() && proof_dir != NULL)){
+            delete S;
+            S = new Solver();
+            if (!S->loadState(state)){
+                fprintf(stderr, "ERROR! Could not load solver state: %s\n", state);
+                delete S;
+                return 1; } }
+
+        if (budget >= 0) S->setConfBudget(budget);
+        else             S->budgetOff();
+        lbool ret = S->solveLimited(cube);
+        Var   v   = var_Undef;
+        if (ret == l_Undef && (v = S->splitVar(cube)) == var_Undef){
+            // -- nothing left to split on, decide the cube here
+            S->budgetOff();
+            ret = S->solveLimited(cube); }
+
+        if (ret == l_False){
+            if (S->proofLogging() && proof_dir != NULL && !writeCubeProof(*S, proof_dir, id)){
+                delete S;
+                return 1; }
+            fprintf(out, "u %d", id);
+            writeLits(out, S->conflict);
+        }else if (ret == l_True){
+            fprintf(out, "s %d", id);
+            for (Var x = 0; x < S->nVars(); x++)
+                if (S->model[x] != l_Undef)
+                    fprintf(out, " %s%d", S->model[x] == l_True ? "" : "-", x + 1);
+            fprintf(out, " 0\n");
+        }else
+            fprintf(out, "i %d %d\n", id, v + 1);
+        fflush(out);
+    }
+
+    delete S;
+    return 0;
+}
+
+
+//=================================================================================================
+// Driver:
+
+
+CubeAndConquer::CubeAndConquer(Solver& _master, int n, int64_t _budget) :
+    command(NULL), state(NULL), proof_dir(NULL), cubes(0), refuted(0), pruned(0), splits(0),
+    master(_master), nworkers(n), budget(_budget), temp_state(false)
+{
+    temp_name[0] = 0;
+}
+
+
+CubeAndConquer::~CubeAndConquer()
+{
+    stop();
+    if (temp_state) unlink(temp_name);
+}
+
+
+int CubeAndConquer::newCube(int parent, Lit p)
+{
+    Cube c;
+    c.start    = cube_lits.size();
+    c.size     = 0;
+    c.by       = -1;
+    c.conflict = -1;
+    if (parent >= 0)
+        for (int i = 0; i < cube_info[parent].size; i++){
+            Lit q = cube_lits[cube_info[parent].start + i];
+            cube_lits.push(q); }
+    if (p != lit_Undef) cube_lits.push(p);
+    c.size = cube_lits.size() - c.start;
+
+    cube_info.push(c);
+    cubes++;
+    return cube_info.size() - 1;
+}
+
+
+void CubeAndConquer::cubeOf(int c, vec<Lit>& out) const
+{
+    out.clear();
+    for (int i = 0; i < cube_info[c].size; i++)
+        out.push(cube_lits[cube_info[c].start + i]);
+}
+
+
+bool CubeAndConquer::prune(int c)
+{
+    const Lit* lits = &cube_lits[cube_info[c].start];
+    int        size = cube_info[c].size;
+
+    // -- refuted if the cube falsifies every literal of a conflict clause
+    for (int r = 0; r < refutations.size(); r++){
+        const Lit* k = &conflict_lits[cube_info[refutations[r]].conflict];
+        for (; *k != lit_Undef; k++){
+            int i = 0;
+            while (i < size && lits[i] != ~*k) i++;
+            if (i == size) break; }
+        if (*k == lit_Undef){
+            cube_info[c].by = refutations[r];
+            pruned++;
+            return true; }
+    }
+    return false;
+}
+
+
+bool CubeAndConquer::start(int i)
+{
+    int to[2], from[2];
+    if (pipe(to) != 0) return false;
+    if (pipe(from) != 0){
+        close(to[0]); close(to[1]);
+        return false; }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0){
+        close(to[0]); close(to[1]); close(from[0]); close(from[1]);
+        return false; }
+
+    if (pid == 0){
+        // -- the pipes of the other workers belong to the driver
+        close(to[1]); close(from[0]);
+        for (int j = 0; j < workers.size(); j++){
+            close(fileno(workers[j].in)); close(fileno(workers[j].out)); }
+
+        if (command == NULL)
+            _exit(serveCubes(state, fdopen(to[0], "r"), fdopen(from[1], "w"), proof_dir));
+
+        char num[16];
+        snprintf(num, sizeof(num), "%d", i);
+        setenv("MINISAT_CUBE_WORKER", num, 1);
+        setenv("MINISAT_CUBE_STATE", state, 1);
+        dup2(to[0], 0); dup2(from[1], 1);
+        close(to[0]); close(from[1]);
+        execl("/bin/sh", "sh", "-c", command, (char*)NULL);
+        _exit(127);
+    }
+
+    close(to[0]); close(from[1]);
+    Worker w;
+    w.pid  = pid;
+    w.in   = fdopen(to[1], "w");
+    w.out  = fdopen(from[0], "r");
+    w.cube = -1;
+    workers.push(w);
+    return true;
+}
+
+
+void CubeAndConquer::stop()
+{
+    // -- an idle worker exits at the end of its input, a busy one is not waited for
+    for (int i = 0; i < workers.size(); i++){
+        fclose(workers[i].in);
+        if (workers[i].cube >= 0) kill(workers[i].pid, SIGTERM); }
+    for (int i = 0; i < workers.size(); i++){
+        fclose(workers[i].out);
+        while (waitpid(workers[i].pid, NULL, 0) < 0 && errno == EINTR); }
+    workers.clear();
+}
+
+
+bool CubeAndConquer::send(Worker& w, int c)
+{
+    cubeOf(c, tmp);
+    fprintf(w.in, "c %d %" PRId64, c, budget);
+    writeLits(w.in, tmp);
+    w.cube = c;
+    return fflush(w.in) == 0;
+}
+
+
+// Reads the answer of a busy worker. Sets 'result' if it decided the problem, and returns false if the
+// worker did not answer:
+bool CubeAndConquer::receive(Worker& w, lbool& result)
+{
+    char kind;
+    int  id;
+    int  c = w.cube;
+    if (fscanf(w.out, " %c %d", &kind, &id) != 2 || id != c) return false;
+    w.cube = -1;
+
+    if (kind == 'u'){
+        if (!readLits(w.out, tmp)) return false;
+        cube_info[c].conflict = conflict_lits.size();
+        for (int i = 0; i < tmp.size(); i++) conflict_lits.push(tmp[i]);
+        conflict_lits.push(lit_Undef);
+        refutations.push(c);
+        refuted++;
+        // -- a conflict clause without literals refutes the problem
+        if (tmp.size() == 0) result = l_False;
+
+    }else if (kind == 's'){
+        if (!readLits(w.out, tmp)) return false;
+        master.model.clear();
+        master.model.growTo(master.nVars(), l_Undef);
+        for (int i = 0; i < tmp.size(); i++)
+            if (var(tmp[i]) < master.nVars())
+                master.model[var(tmp[i])] = lbool(!sign(tmp[i]));
+        result = l_True;
+
+    }else if (kind == 'i'){
+        int v;
+        if (fscanf(w.out, "%d", &v) != 1 || v < 1 || v > master.nVars()) return false;
+        open.insert(newCube(c, mkLit(v - 1)));
+        open.insert(newCube(c, ~mkLit(v - 1)));
+        splits++;
+
+    }else
+        return false;
+    return true;
+}
+
+
+void CubeAndConquer::writeManifest() const
+{
+    std::string file = std::string(proof_dir) + "/cubes";
+    FILE* out = fopen(file.c_str(), "w");
+    if (out == NULL){
+        fprintf(stderr, "ERROR! Could not open file: %s\n", file.c_str());
+        return; }
+
+    vec<Lit> lits;
+    for (int c = 0; c < cube_info.size(); c++){
+        if (cube_info[c].conflict >= 0){
+            fprintf(out, "r %d", c);
+            cubeOf(c, lits);
+            for (int i = 0; i < lits.size(); i++) fprintf(out, " %s%d", sign(lits[i]) ? "-" : "", var(lits[i]) + 1);
+            fprintf(out, " 0");
+            lits.clear();
+            for (const Lit* k = &conflict_lits[cube_info[c].conflict]; *k != lit_Undef; k++) lits.push(*k);
+            writeLits(out, lits);
+        }else if (cube_info[c].by >= 0){
+            fprintf(out, "p %d %d", c, cube_info[c].by);
+            cubeOf(c, lits);
+            writeLits(out, lits); }
+    }
+    fclose(out);
+}
+
+
+lbool CubeAndConquer::solve()
+{
+    vec<Lit> none;
+    master.setConfBudget(budget);
+    lbool ret = master.solveLimited(none);
+    master.budgetOff();
+    if (ret != l_Undef) return ret;
+
+    // -- the first cubes split on the variables the driver favours most, until there are enough for all workers
+    open.insert(newCube(-1, lit_Undef));
+    while (open.size() < 2 * nworkers){
+        int c = open.peek();
+        cubeOf(c, tmp);
+        Var v = master.splitVar(tmp);
+        if (v == var_Undef) break;
+        open.pop();
+        open.insert(newCube(c, mkLit(v)));
+        open.insert(newCube(c, ~mkLit(v)));
+        splits++;
+    }
+
+    if (state == NULL){
+        strcpy(temp_name, "/tmp/minisat-cubes-XXXXXX");
+        int fd = mkstemp(temp_name);
+        if (fd < 0){
+            fprintf(stderr, "ERROR! Could not create a temporary file for the cube workers.\n");
+            return l_Undef; }
+        close(fd);
+        state      = temp_name;
+        temp_state = true;
+    }
+    if (!master.saveState(state)){
+        fprintf(stderr, "ERROR! Could not save solver state: %s\n", state);
+        return l_Undef; }
+
+    // -- a worker that exits early must not take the driver with it
+    signal(SIGPIPE, SIG_IGN);
+    bool ok = true;
+    for (int i = 0; i < nworkers && ok; i++)
+        ok = start(i);
+
+    lbool        result = l_Undef;
+    vec<pollfd>  fds;
+    vec<int>     busy;
+    while (ok && result == l_Undef){
+        // -- hand out the open cubes that no conflict clause refutes
+        for (int i = 0; i < workers.size() && ok; i++)
+            while (ok && workers[i].cube < 0 && open.size() > 0){
+                int c = open.peek();
+                open.pop();
+                if (!prune(c)) ok = send(workers[i], c); }
+
+        fds.clear();
+        busy.clear();
+        for (int i = 0; i < workers.size(); i++)
+            if (workers[i].cube >= 0){
+                pollfd p;
+                p.fd      = fileno(workers[i].out);
+                p.events  = POLLIN;
+                p.revents = 0;
+                fds.push(p);
+                busy.push(i); }
+
+        // -- every cube was refuted or pruned
+        if (ok && fds.size() == 0){
+            result = l_False;
+            break; }
+
+        if (!ok || poll(&fds[0], fds.size(), -1) < 0){
+            ok = ok && errno == EINTR;
+            continue; }
+        for (int j = 0; j < fds.size() && ok && result == l_Undef; j++)
+            if (fds[j].revents != 0)
+                ok = receive(workers[busy[j]], result);
+    }
+    stop();
+
+    if (!ok){
+        fprintf(stderr, "ERROR! A cube worker failed.\n");
+        return l_Undef; }
+    if (result == l_False && proof_dir != NULL && master.proofLogging())
+        writeManifest();
+    return result;
+}
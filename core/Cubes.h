@@ -0,0 +1,115 @@
+#ifndef Minisat_Cubes_h
+#define Minisat_Cubes_h
+
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "mtl/Queue.h"
+#include "core/Solver.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// CubeAndConquer -- a search split into cubes that worker processes solve:
+//
+// A cube is a conjunction of literals, which a worker passes to 'solveLimited()' as assumptions,
+// within a conflict budget. The driver searches within the budget itself first, then splits the
+// problem on its most active variables into cubes, one for every combination of their values.
+// A cube that a worker does not decide is split again on the variable the worker favours most
+// (see 'Solver::splitVar()'). A refuted cube answers with its final 'conflict' clause, which also
+// refutes every cube that contains the negations of all its literals, such as a sibling that the
+// clause does not mention the split variable of. Such cubes are pruned before they are sent. The
+// problem is satisfiable once a cube is, and unsatisfiable once all cubes are refuted.
+//
+// Every worker starts from a snapshot of the driver (see 'Solver::saveState()'). By default a
+// worker is a forked process. With 'command' set, it is started by that shell command, which can
+// run it on another node (e.g. 'ssh node1 minisat_core -cube-worker=/shared/state'), as long as
+// the snapshot is on a file system both share. The command finds the number of the worker and
+// the snapshot in the environment variables MINISAT_CUBE_WORKER and MINISAT_CUBE_STATE.
+//
+// With proof logging and 'proof_dir' set, every worker refutes a cube from a fresh copy of the
+// snapshot, validates the proof and writes it in trace-check format to 'cube-<id>.trace' in
+// 'proof_dir'. The literals of the cube appear in it as unit clauses without antecedents, so that
+// it refutes the problem and the cube. Once the problem is refuted, the driver writes the
+// manifest 'cubes' next to them, which lists every cube that was not split:
+//
+//   r <id> <cube> 0 <conflict> 0      refuted by the proof in 'cube-<id>.trace'
+//   p <id> <by> <cube> 0              pruned by the conflict clause of refuted cube <by>
+//
+// The conflict clauses together with the cubes refute the problem, which glues the proofs.
+//
+// The driver and the workers talk over pipes, one line per message, literals as in DIMACS:
+//
+//   c <id> <budget> <cube> 0          driver: solve cube <id> within <budget> conflicts (-1 = none)
+//   u <id> <conflict> 0               worker: the cube is refuted, by this final conflict clause
+//   s <id> <model> 0                  worker: the cube is satisfiable, by this model
+//   i <id> <var>                      worker: not decided, split on variable <var>
+
+
+class CubeAndConquer {
+ public:
+    CubeAndConquer(Solver& master, int nworkers, int64_t budget);
+    ~CubeAndConquer();
+
+    const char* command;        // Shell command that starts a worker, or NULL to fork one.
+    const char* state;          // Snapshot the workers start from, or NULL for a temporary file.
+    const char* proof_dir;      // Directory for the proofs of the refuted cubes and their manifest, or NULL.
+
+    // Solve the problem of 'master'. If satisfiable, the model is put into 'master.model':
+    lbool    solve        ();
+
+    // Statistics: (read-only member variables)
+    //
+    int      cubes, refuted, pruned, splits;
+
+ private:
+    struct Cube {
+        int start, size;        // The literals of the cube are 'cube_lits[start..start+size)'.
+        int by;                 // The refuted cube whose conflict clause pruned this one, or -1.
+        int conflict;           // Start of the conflict clause in 'conflict_lits' if refuted, or -1.
+    };
+
+    struct Worker {
+        pid_t pid;
+        FILE* in;               // Cubes to the worker,
+        FILE* out;              // and its answers.
+        int   cube;             // The cube it solves, or -1 if it is idle.
+    };
+
+    Solver&        master;
+    int            nworkers;
+    int64_t        budget;
+    bool           temp_state;  // Whether 'state' is a temporary file of the driver.
+    char           temp_name[64];
+
+    vec<Cube>      cube_info;
+    vec<Lit>       cube_lits;
+    vec<Lit>       conflict_lits;   // The conflict clauses of the refuted cubes, each followed by lit_Undef.
+    vec<int>       refutations;     // The refuted cubes, in the order of their answers.
+    Queue<int>     open;            // Cubes that were neither sent to a worker nor split.
+    vec<Worker>    workers;
+    vec<Lit>       tmp;
+
+    int      newCube      (int parent, Lit p);          // A cube with the literals of 'parent' (or none) and 'p' (unless undefined).
+    void     cubeOf       (int c, vec<Lit>& out) const;
+    bool     prune        (int c);                      // Whether a conflict clause refutes cube 'c', recording it.
+    bool     start        (int i);
+    void     stop         ();
+    bool     send         (Worker& w, int c);
+    bool     receive      (Worker& w, lbool& result);
+    void     writeManifest() const;
+
+    // Not copyable:
+    CubeAndConquer(const CubeAndConquer&);
+    CubeAndConquer& operator=(const CubeAndConquer&);
+};
+
+
+// Serves the cubes sent on 'in' and answers them on 'out', starting from the snapshot 'state' (see
+// 'CubeAndConquer'). Returns the exit status of the worker:
+int serveCubes(const char* state, FILE* in, FILE* out, const char* proof_dir);
+
+//=================================================================================================
+}
+
+#endif
@@ -24,6 +24,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <stdio.h>
 
 #include "utils/ParseUtils.h"
+#include "utils/DimacsTokens.h"
 #include "core/SolverTypes.h"
 
 namespace Minisat {
@@ -88,6 +89,52 @@ static void parse_DIMACS(gzFile input_stream, Solver& S) {
     StreamBuffer in(input_stream);
     parse_DIMACS_main(in, S); }
 
+// Inserts the clauses of an already tokenized file, in the order of the file, as one bulk load.
+//
+template<class Solver>
+static void parse_DIMACS_tokens(const DimacsTokens& in, Solver& S) {
+    // -- variables are numbered as in the file, so creating them all up front gives the same solver
+    while (in.maxVar() > S.nVars()) S.newVar();
+    S.beginClauses(in.clauses(), in.literals());
+
+    vec<Lit> clause;
+    int      cnt = 0;
+    for (int i = 0; i < in.chunks(); i++){
+        const vec<int>& ts = in.chunk(i);
+        for (int j = 0; j < ts.size(); j++){
+            int t = ts[j];
+            if (t == DimacsTokens::PartMark){
+                if (clause.size() > 0) fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", 'c'), exit(3);
+                S.setCurrentPart(S.getCurrentPart() + 1);
+            }else if (t == 0){
+                cnt++;
+                S.addClause_(clause);
+                clause.clear();
+            }else
+                clause.push(t > 0 ? mkLit(t - 1) : ~mkLit(-t - 1));
+        }
+    }
+    if (clause.size() > 0)
+        fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", EOF), exit(3);
+    S.commitClauses();
+
+    if (in.header_vars != S.nVars())
+        fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of variables.\n");
+    if (cnt != in.header_clauses)
+        fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of clauses.\n");
+}
+
+// Inserts problem into solver, reading 'file' (standard input if NULL) with 'nthreads' threads.
+// Returns false if the file can not be opened.
+//
+template<class Solver>
+static bool parse_DIMACS(const char* file, Solver& S, int nthreads) {
+    DimacsTokens in;
+    if (!in.load(file)) return false;
+    in.tokenize(nthreads);
+    parse_DIMACS_tokens(in, S);
+    return true; }
+
 //=================================================================================================
 }
 
@@ -0,0 +1,134 @@
+#include "InterpolantVisitor.h"
+
+namespace Minisat
+{
+  InterpolantVisitor::InterpolantVisitor (Solver &solver)
+    : m_Solver (solver), m_first (0), m_cuts (0), m_clause (-1), m_done (false)
+  {
+    Range total = m_Solver.getTotalPart ();
+    if (!total.undef ())
+    {
+      m_first = total.min ();
+      m_cuts = total.max () - total.min ();
+    }
+    m_unit.growTo (m_Solver.nVars (), -1);
+    m_input.growTo (m_Solver.nVars (), -1);
+    m_tmp.growTo (m_cuts, Aig::True);
+    m_itp.growTo (m_cuts, Aig::True);
+  }
+
+  int InterpolantVisitor::input (Var v)
+  {
+    if (m_input [v] < 0)
+    {
+      m_input [v] = m_aig.mkInput ();
+      m_inputVar.push (v);
+    }
+    return m_input [v];
+  }
+
+  /// -- allocates a label and copies 'm_tmp' into it
+  int InterpolantVisitor::newLabel ()
+  {
+    int base = m_labels.size ();
+    for (int j = 0; j < m_cuts; ++j) m_labels.push (m_tmp [j]);
+    return base;
+  }
+
+  int InterpolantVisitor::leafLabel (const Lit *lits, int size, Range part)
+  {
+    for (int j = 0; j < m_cuts; ++j)
+    {
+      unsigned k = m_first + j;
+      int itp = Aig::True;
+      if (part.max () <= k)
+      {
+        itp = Aig::False;
+        for (int i = 0; i < size; ++i)
+          if (m_Solver.getVarRange (var (lits [i])).max () > k)
+          {
+            int x = input (var (lits [i]));
+            itp = m_aig.mkOr (itp, sign (lits [i]) ? Aig::neg (x) : x);
+          }
+      }
+      m_tmp [j] = itp;
+    }
+    return newLabel ();
+  }
+
+  int InterpolantVisitor::clauseLabel (CRef cr)
+  {
+    if (m_clause.has (cr)) return m_clause [cr];
+
+    const Clause &c = m_Solver.getClause (cr);
+    int lbl = leafLabel ((const Lit*) c, c.size (), c.part ());
+    m_clause.insert (cr, lbl);
+    return lbl;
+  }
+
+  int InterpolantVisitor::unitLabel (Lit p)
+  {
+    Var v = var (p);
+    if (m_unit [v] >= 0) return m_unit [v];
+
+    // -- a unit that was not derived by a step is implied by a unit clause,
+    // -- or it is an assumption
+    CRef r = m_Solver.getReason (v);
+    if (r != CRef_Undef) return m_unit [v] = clauseLabel (r);
+
+    Range part (m_Solver.getVarRange (v).min ());
+    return m_unit [v] = leafLabel (&p, 1, part);
+  }
+
+  int InterpolantVisitor::visitStep (const ProofStep &s)
+  {
+    if (m_cuts == 0)
+    {
+      m_done = m_done || (s.kind == ProofStep::ChainClause && s.clause == CRef_Undef);
+      return 0;
+    }
+
+    // -- labels of all antecedents are allocated before 'm_tmp' is used
+    int first = clauseLabel (s.clauses [0]);
+    for (int i = 0; i < s.nPivots; ++i)
+      if (i + 1 < s.nClauses && s.clauses [i+1] != CRef_Undef) clauseLabel (s.clauses [i+1]);
+      else unitLabel (s.pivots [i]);
+
+    for (int j = 0; j < m_cuts; ++j) m_tmp [j] = m_labels [first + j];
+
+    for (int i = 0; i < s.nPivots; ++i)
+    {
+      int other = i + 1 < s.nClauses && s.clauses [i+1] != CRef_Undef ?
+        clauseLabel (s.clauses [i+1]) : unitLabel (s.pivots [i]);
+      unsigned local = m_Solver.getVarRange (var (s.pivots [i])).max ();
+
+      for (int j = 0; j < m_cuts; ++j)
+      {
+        int o = m_labels [other + j];
+        m_tmp [j] = local <= (unsigned) (m_first + j) ?
+          m_aig.mkOr (m_tmp [j], o) : m_aig.mkAnd (m_tmp [j], o);
+      }
+    }
+
+    if (s.kind != ProofStep::ChainClause)
+      m_unit [var (s.lit)] = newLabel ();
+    else if (s.clause != CRef_Undef)
+    {
+      // -- a clause that is derived again gets the label of its new derivation
+      m_clause.insert (s.clause, newLabel ());
+    }
+    else
+    {
+      for (int j = 0; j < m_cuts; ++j) m_itp [j] = m_tmp [j];
+      m_done = true;
+    }
+    return 0;
+  }
+
+  void InterpolantVisitor::writeAiger (FILE *out) const
+  {
+    m_aig.writeAiger (out, m_itp);
+    for (int i = 0; i < m_inputVar.size (); ++i)
+      fprintf (out, "i%d %d\n", i, m_inputVar [i] + 1);
+  }
+}
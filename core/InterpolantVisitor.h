@@ -0,0 +1,74 @@
+#ifndef _INTERPOLANT_VISITOR_H_
+#define _INTERPOLANT_VISITOR_H_
+
+#include "ProofVisitor.h"
+#include "Solver.h"
+#include "Aig.h"
+
+#include <cstdio>
+
+namespace Minisat
+{
+  /// Builds sequence interpolants as an AIG while the solver replays a
+  /// proof. There is one interpolant for each cut 'k' between the
+  /// partitions '<= k' (A) and '> k' (B), for 'k' from the first to the
+  /// one before the last partition of the solver, all from a single replay.
+  ///
+  /// The partial interpolants follow McMillan's system: a clause of A is
+  /// labelled with the disjunction of its literals over variables that occur
+  /// in B, a clause of B with true, and a resolvent with the disjunction of
+  /// its antecedents' labels if the pivot occurs only in A, and their
+  /// conjunction otherwise. Variables are shared according to
+  /// 'Solver::getVarRange ()', which validate () restricts to the core.
+  /// An assumption is a unit of the first partition of its variable.
+  class InterpolantVisitor : public StaticProofVisitor<InterpolantVisitor>
+  {
+  protected:
+    Solver &m_Solver;
+    Aig m_aig;
+
+    /// -- the cut of index 'j' is between partitions 'm_first + j' and above
+    int m_first;
+    int m_cuts;
+
+    /// -- 'm_cuts' partial interpolants for each labelled clause or unit
+    vec<int> m_labels;
+    /// -- label of each clause, -1 if not labelled yet
+    RefTable<CRef, int> m_clause;
+    /// -- label of the level 0 unit of each variable, -1 if none
+    vec<int> m_unit;
+    /// -- AIG input of each variable, -1 if none
+    vec<int> m_input;
+    vec<Var> m_inputVar;
+    vec<int> m_tmp;
+    vec<int> m_itp;
+    bool m_done;
+
+    int input (Var v);
+    int newLabel ();
+    int leafLabel (const Lit *lits, int size, Range part);
+    int clauseLabel (CRef cr);
+    int unitLabel (Lit p);
+
+  public:
+    InterpolantVisitor (Solver &solver);
+
+    int visitStep (const ProofStep &s);
+
+    /// -- number of cuts, 0 if the solver has a single partition
+    int cuts () const { return m_cuts; }
+    /// -- true once the empty clause was visited
+    bool done () const { return m_done; }
+    /// -- AIG literal of the interpolant between partitions '<= k' and '> k'
+    int interpolant (int k) const { return m_itp [k - m_first]; }
+    /// -- solver variable of each AIG input
+    Var inputVar (int i) const { return m_inputVar [i]; }
+
+    const Aig &aig () const { return m_aig; }
+
+    /// -- writes the interpolants as the outputs of an ASCII AIGER file,
+    /// -- the symbol of each input is the DIMACS number of its variable
+    void writeAiger (FILE *out) const;
+  };
+}
+#endif
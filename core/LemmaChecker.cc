@@ -0,0 +1,240 @@
+#include "core/LemmaChecker.h"
+
+using namespace Minisat;
+
+LemmaChecker::LemmaChecker(ProofTable& t, int i, int n, int ch) :
+    table(t), ante(t.ante[i]), id(i), nthreads(n), chunk(ch), qhead(0), decision_level(0), confl0(-1)
+{
+    assigns.growTo(t.nvars, l_Undef);
+    reason .growTo(t.nvars, -1);
+    level  .growTo(t.nvars, 0);
+    seen   .growTo(t.nvars, 0);
+    watches.growTo(2 * t.nvars);
+    watch  .growTo(2 * t.nClauses(), 0);
+    live   .growTo(t.nClauses(), 0);
+}
+
+
+void LemmaChecker::run()
+{
+    // -- the database has to be built only up to the last lemma of this thread
+    int end = table.to;
+    while (end > table.from && !mine(end - 1)) end--;
+    if (end <= table.from) return;
+
+    for (int c = 0; c < table.nClauses(); c++)
+        if (table.initial[c]) addClause(c);
+
+    for (int i = 0; i < end; i++){
+        int c = table.step[i];
+        if (!table.add[i])
+            // -- units implied by a deleted clause stay, as they do on the trail of the solver
+            live[c] = 0;
+        else{
+            if (mine(i)) check(i);
+            addClause(c);
+        }
+    }
+}
+
+
+void LemmaChecker::enqueue(Lit p, int from)
+{
+    assert(value(p) == l_Undef);
+    assigns[var(p)] = lbool(!sign(p));
+    reason [var(p)] = from;
+    level  [var(p)] = decision_level;
+    trail.push(p);
+}
+
+
+void LemmaChecker::cancel(int sz)
+{
+    for (int k = trail.size() - 1; k >= sz; k--){
+        Var x = var(trail[k]);
+        assigns[x] = l_Undef;
+        reason [x] = -1;
+    }
+    trail.shrink(trail.size() - sz);
+    qhead = sz;
+    decision_level = 0;
+}
+
+
+void LemmaChecker::addClause(int cr)
+{
+    live[cr] = 1;
+    if (confl0 >= 0) return;
+
+    const Lit* c  = table.clause(cr);
+    int        sz = table.size(cr);
+
+    // -- watch two literals that are not false, a clause that is unit or satisfied at level 0
+    // -- stays so, and can watch a false literal
+    int a = -1, b = -1;
+    for (int k = 0; k < sz && b < 0; k++)
+        if (value(c[k]) != l_False){
+            if (a < 0) a = k;
+            else       b = k; }
+
+    if (a < 0){ confl0 = cr; return; }
+    if (b < 0){
+        if (value(c[a]) == l_Undef) enqueue(c[a], cr);
+        b = a == 0 ? 1 : 0; }
+
+    if (sz > 1){
+        watch[2*cr] = a, watch[2*cr+1] = b;
+        watches[toInt(c[a])].push(Watch(cr, c[b]));
+        watches[toInt(c[b])].push(Watch(cr, c[a])); }
+
+    int confl = propagate();
+    if (confl >= 0) confl0 = confl;
+}
+
+
+int LemmaChecker::propagate()
+{
+    int confl = -1;
+
+    while (qhead < trail.size()){
+        Lit         f  = ~trail[qhead++];     // 'f' is the literal that became false.
+        vec<Watch>& ws = watches[toInt(f)];
+        Watch      *i, *j, *end;
+
+        for (i = j = (Watch*)ws, end = i + ws.size(); i != end;){
+            Watch w = *i++;
+            // -- drop the watchers of deleted clauses
+            if (!live[w.cref]) continue;
+            if (value(w.blocker) == l_True){ *j++ = w; continue; }
+
+            const Lit* c   = table.clause(w.cref);
+            int        sz  = table.size(w.cref);
+            int*       pos = &watch[2 * w.cref];
+
+            // -- make sure the false literal is the first watch
+            if (c[pos[0]] != f){ int tmp = pos[0]; pos[0] = pos[1]; pos[1] = tmp; }
+            assert(c[pos[0]] == f);
+
+            Lit other = c[pos[1]];
+            if (other != w.blocker && value(other) == l_True){ *j++ = Watch(w.cref, other); continue; }
+
+            // -- look for a new watch
+            int k;
+            for (k = 0; k < sz; k++)
+                if (k != pos[0] && k != pos[1] && value(c[k]) != l_False) break;
+            if (k < sz){
+                pos[0] = k;
+                watches[toInt(c[k])].push(Watch(w.cref, other));
+                continue; }
+
+            // -- did not find a watch, the clause is unit or conflicting
+            *j++ = Watch(w.cref, other);
+            if (value(other) == l_False){
+                confl = w.cref;
+                qhead = trail.size();
+                while (i < end) *j++ = *i++;
+            }else
+                enqueue(other, w.cref);
+        }
+        ws.shrink(i - j);
+    }
+
+    return confl;
+}
+
+
+bool LemmaChecker::check(int i)
+{
+    int        cr = table.step[i];
+    const Lit* c  = table.clause(cr);
+    int        sz = table.size(cr);
+    int        sz0 = trail.size();
+
+    table.owner[i] = id;
+    table.first[i] = ante.size();
+    units.clear();
+
+    // -- assume the negation of the lemma at level 1
+    bool valid = confl0 >= 0;
+    int  confl = confl0;
+    decision_level = 1;
+    for (int k = 0; k < sz && !valid; k++){
+        lbool v = value(c[k]);
+        if (v == l_Undef)
+            enqueue(~c[k], -1);
+        else if (level[var(c[k])] == 0){
+            // -- literals of level 0 are part of the conflict, a true one makes the lemma valid
+            units.push(var(c[k]));
+            valid = v == l_True; }
+        else
+            // -- a repeated literal, or a tautology
+            valid = v == l_True;
+    }
+
+    if (!valid) confl = propagate();
+    valid = valid || confl >= 0;
+    if (valid) analyze(confl, i);
+
+    cancel(sz0);
+    table.count [i] = ante.size() - table.first[i];
+    table.status[i] = valid ? ProofTable::Valid : ProofTable::Invalid;
+    return valid;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  analyze : (confl : int) (i : int)  ->  [void]
+|
+|  Description:
+|    Records the conflicting clause and the reasons of all variables that the conflict depends on
+|    as the antecedents of the lemma of step 'i'. A variable of level 0 that is still on the trail
+|    of the solver when validation reaches step 'i' is recorded by itself, and the solver marks
+|    its own reason for it, just as it would after checking the lemma itself.
+|________________________________________________________________________________________________@*/
+void LemmaChecker::analyze(int confl, int i)
+{
+    int lim = table.unit_lim[i];
+
+    stack.clear();
+    for (int k = 0; k < units.size(); k++)
+        if (!seen[units[k]]){
+            seen[units[k]] = 1;
+            stack.push(units[k]);
+            toclear.push(units[k]); }
+
+    if (confl >= 0){
+        ante.push(confl);
+        const Lit* c = table.clause(confl);
+        for (int k = 0; k < table.size(confl); k++)
+            if (!seen[var(c[k])]){
+                seen[var(c[k])] = 1;
+                stack.push(var(c[k]));
+                toclear.push(var(c[k])); }
+    }
+
+    while (stack.size() > 0){
+        Var x = stack.last(); stack.pop();
+
+        if (level[x] == 0 && table.unit_pos[x] < lim && table.unit_val[x] == assigns[x]){
+            ante.push(ProofTable::mkUnit(x));
+            continue; }
+
+        int r = reason[x];
+        if (r < 0) continue;
+        ante.push(r);
+
+        const Lit* c = table.clause(r);
+        for (int k = 0; k < table.size(r); k++){
+            Var y = var(c[k]);
+            if (!seen[y]){
+                seen[y] = 1;
+                stack.push(y);
+                toclear.push(y); }
+        }
+    }
+
+    for (int k = 0; k < toclear.size(); k++)
+        seen[toclear[k]] = 0;
+    toclear.clear();
+}
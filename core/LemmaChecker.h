@@ -0,0 +1,109 @@
+#ifndef Minisat_LemmaChecker_h
+#define Minisat_LemmaChecker_h
+
+#include "core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// ProofTable -- a copy of the clausal proof that is shared read-only by the checking threads:
+
+
+struct ProofTable {
+    vec<Lit>   lits;      // Literals of clause 'c' are 'lits[start[c]]' .. 'lits[start[c+1]-1]'.
+    vec<int>   start;
+    vec<char>  initial;   // 'initial[c]' is set if clause 'c' is in the database before the first step.
+    vec<int>   step;      // Clause of each proof step.
+    vec<char>  add;       // Is the step a lemma (as opposed to a deletion)?
+    vec<int>   origin;    // Where the solver keeps clause 'c': 'clauses[origin[c]]', or 'proof[-origin[c]-1]' if negative.
+
+    // The level 0 trail of the solver when validation starts:
+    vec<lbool> unit_val;  // Value of each variable on that trail.
+    vec<int>   unit_pos;  // Position of each variable on that trail, or INT32_MAX.
+    vec<int>   unit_lim;  // 'unit_lim[i]' is the prefix of the trail that is left when validation reaches step 'i'.
+
+    int        nvars;
+    int        from;      // The lemmas of the steps 'from' .. 'to-1' are checked.
+    int        to;
+
+    // Outcome of the check of each step, filled in by the threads:
+    enum { Unchecked = 0, Valid = 1, Invalid = 2 };
+    vec<char>  status;
+    vec<int>   owner;     // Thread that checked the step.
+    vec<int>   first;     // Offset of the antecedents of the step in the 'ante' of its thread.
+    vec<int>   count;
+    vec<vec<int> > ante;  // Antecedents found by each thread.
+
+    ProofTable() : nvars(0), from(0), to(0) {}
+
+    int  nClauses   ()            const { return start.size() - 1; }
+    int  size       (int c)       const { return start[c+1] - start[c]; }
+    const Lit* clause (int c)     const { return &lits[start[c]]; }
+
+    // Antecedents are clauses (>= 0), or variables (< 0) whose reason on the trail of the solver
+    // should be used:
+    static int  mkUnit  (Var x)         { return -x - 1; }
+    static bool isUnit  (int a)         { return a < 0; }
+    static Var  unitVar (int a)         { return -a - 1; }
+};
+
+
+//=================================================================================================
+// LemmaChecker -- checks the lemmas of one share of a proof with a database of its own:
+//
+// The checker goes forward through the proof, adding lemmas and removing deleted clauses from its
+// private watch lists, and checks the lemmas of every 'nthreads'th chunk of the steps by unit
+// propagation (RUP). For each lemma it records the clauses that take part in the conflict, so
+// that the backward pass of 'Solver::validate()' can mark the core without propagating again.
+// Clause literals are shared through the 'ProofTable' and never reordered, the two watched
+// literals of each clause are kept by position instead.
+
+class LemmaChecker {
+public:
+    LemmaChecker(ProofTable& t, int id, int nthreads, int chunk);
+
+    void     run        ();              // Check the share of this thread (entry point of the thread).
+
+protected:
+    struct Watch {
+        int cref;
+        Lit blocker;
+        Watch(int cr, Lit p) : cref(cr), blocker(p) {}
+    };
+
+    ProofTable&      table;
+    vec<int>&        ante;               // Antecedents of the checked lemmas (see 'ProofTable').
+    int              id;
+    int              nthreads;
+    int              chunk;
+
+    vec<lbool>       assigns;
+    vec<int>         reason;             // Clause that implied the variable, or -1 for a decision.
+    vec<char>        level;              // 0 for the units of the database, 1 for the checked lemma.
+    vec<Lit>         trail;
+    int              qhead;
+    char             decision_level;     // 1 while a lemma is checked, 0 otherwise.
+    int              confl0;             // Conflict of the database at level 0, or -1.
+    vec<vec<Watch> > watches;            // 'watches[lit]' is a list of clauses watching 'lit'.
+    vec<int>         watch;              // Positions of the two watched literals of each clause.
+    vec<char>        live;
+    vec<char>        seen;
+    vec<Var>         units;              // Variables of level 0 that the checked lemma depends on.
+    vec<Var>         stack;
+    vec<Var>         toclear;
+
+    lbool    value      (Lit p) const { return assigns[var(p)] ^ sign(p); }
+    bool     mine       (int i) const { return i >= table.from && ((i - table.from) / chunk) % nthreads == id; }
+    void     enqueue    (Lit p, int from);
+    int      propagate  ();              // Returns the conflicting clause, or -1.
+    void     addClause  (int cr);        // Add a clause at level 0 and propagate its units.
+    bool     check      (int i);         // RUP check of the lemma of step 'i', recording its antecedents.
+    void     analyze    (int confl, int i); // Record the clauses 'confl' and 'units' depend on.
+    void     cancel     (int sz);
+};
+
+
+//=================================================================================================
+}
+
+#endif
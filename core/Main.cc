@@ -28,6 +28,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/Options.h"
 #include "core/Dimacs.h"
 #include "core/Solver.h"
+#include "core/Portfolio.h"
+#include "core/Cubes.h"
 #include "core/TraceProofVisitor.h"
 using namespace Minisat;
 
@@ -51,10 +53,11 @@ void printStats(Solver& solver)
 }
 
 
-static Solver* solver;
-// Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
+static Solver*    solver;
+static Portfolio* portfolio;
+// Terminate by notifying the solvers and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
-static void SIGINT_interrupt(int signum) { solver->interrupt(); }
+static void SIGINT_interrupt(int signum) { portfolio->interrupt(); }
 
 // Note that '_exit()' rather than 'exit()' has to be used. The reason is that 'exit()' calls
 // destructors and may cause deadlocks if a malloc/free function happens to be running (these
@@ -67,6 +70,24 @@ static void SIGINT_exit(int signum) {
     _exit(1); }
 
 
+//=================================================================================================
+// Writes the proof of an UNSAT answer in trace-check format:
+
+static void writeTrace(Solver& S, const char* file, bool binary, bool compress)
+{
+    if (compress){
+        gzFile out = gzopen(file, "wb");
+        if (out == NULL){ fprintf(stderr, "ERROR! Could not open file: %s\n", file); return; }
+        { TraceWriter w(out, binary); TraceProofVisitor v(S, w); S.replay(v); }
+        gzclose(out);
+    }else{
+        FILE* out = fopen(file, binary ? "wb" : "w");
+        if (out == NULL){ fprintf(stderr, "ERROR! Could not open file: %s\n", file); return; }
+        { TraceWriter w(out, binary); TraceProofVisitor v(S, w); S.replay(v); }
+        fclose(out);
+    }
+}
+
 //=================================================================================================
 // Main:
 
@@ -80,7 +101,6 @@ int main(int argc, char** argv)
 #if defined(__linux__)
         fpu_control_t oldcw, newcw;
         _FPU_GETCW(oldcw); newcw = (oldcw & ~_FPU_EXTENDED) | _FPU_DOUBLE; _FPU_SETCW(newcw);
-        printf("WARNING: for repeatability, setting FPU to use double precision\n");
 #endif
         // Extra options:
         //
@@ -89,15 +109,37 @@ int main(int argc, char** argv)
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
         
         StringOption tcpf ("MAIN", "tcpf", "If given, write proof in trace-check format to this file");
+        BoolOption   tcpf_bin ("MAIN", "tcpf-bin", "Write the trace-check proof in binary (LRAT-style) encoding.", false);
+        BoolOption   tcpf_gz  ("MAIN", "tcpf-gz", "Compress the trace-check proof with gzip.", false);
+        IntOption    parse_threads("MAIN", "parse-threads", "Map the input and split it into clauses with this many threads (0=read it as a stream).", 0, IntRange(0, 1024));
+        StringOption save_state("MAIN", "save-state", "If given, stop after simplification and write the solver state to this file.");
+        StringOption load_state("MAIN", "load-state", "If given, take the solver state from this file (see -save-state) instead of reading the input.");
+        IntOption    solvers   ("MAIN", "portfolio", "Number of diversified solvers that search in parallel.", 1, IntRange(1, 256));
+        IntOption    share_lim ("MAIN", "share-lim", "Share learnt clauses of at most this many literals between the solvers of a portfolio.", 8, IntRange(0, 1024));
+        IntOption    cubes      ("MAIN", "cubes",       "Split the search into cubes that this many worker processes solve (0=off).", 0, IntRange(0, 1024));
+        Int64Option  cube_budget("MAIN", "cube-budget", "Conflicts spent on a cube before it is split further.", 10000, Int64Range(1, INT64_MAX));
+        StringOption cube_cmd   ("MAIN", "cube-cmd",    "Start every cube worker with this shell command instead of forking it (see -cube-worker).");
+        StringOption cube_state ("MAIN", "cube-state",  "Snapshot the cube workers start from, on a file system they share (default: a temporary file).");
+        StringOption cube_proofs("MAIN", "cube-proofs", "Write the proofs of the refuted cubes, and a manifest to glue them, to this directory.");
+        StringOption cube_worker("MAIN", "cube-worker", "Solve the cubes of a driver on standard input and output, starting from this snapshot.");
         
         parseOptions(argc, argv, true);
 
+        // -- a worker answers on standard output, and nothing else may go there
+        if (cube_worker)
+            exit(serveCubes(cube_worker, stdin, stdout, cube_proofs));
+#if defined(__linux__)
+        printf("WARNING: for repeatability, setting FPU to use double precision\n");
+#endif
+
         Solver S;
         double initial_time = cpuTime();
 
         S.verbosity = verb;
+        Portfolio P(S, solvers, share_lim);
         
-        solver = &S;
+        solver    = &S;
+        portfolio = &P;
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
         signal(SIGINT, SIGINT_exit);
@@ -124,19 +166,25 @@ int main(int argc, char** argv)
                     printf("WARNING! Could not set resource limit: Virtual memory.\n");
             } }
         
-        if (argc == 1)
+        if (argc == 1 && !load_state)
             printf("Reading from standard input... Use '--help' for help.\n");
         
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
+        gzFile in = NULL;
+        if (!load_state && parse_threads == 0 && (in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb")) == NULL)
             printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
         
         if (S.verbosity > 0){
             printf("============================[ Problem Statistics ]=============================\n");
             printf("|                                                                             |\n"); }
         
-        parse_DIMACS(in, S);
-        gzclose(in);
+        if (load_state){
+            if (!P.loadState(load_state))
+                printf("ERROR! Could not load solver state: %s\n", (const char*)load_state), exit(1);
+        }else if (in != NULL){
+            parse_DIMACS(in, P);
+            gzclose(in);
+        }else if (!parse_DIMACS(argc == 1 ? NULL : argv[1], P, parse_threads))
+            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
         FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
         
         if (S.verbosity > 0){
@@ -153,7 +201,7 @@ int main(int argc, char** argv)
         signal(SIGINT, SIGINT_interrupt);
         signal(SIGXCPU,SIGINT_interrupt);
        
-        if (!S.simplify()){
+        if (!P.simplify()){
             if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
             if (S.verbosity > 0){
                 printf("===============================================================================\n");
@@ -163,27 +211,48 @@ int main(int argc, char** argv)
             printf("UNSATISFIABLE\n");
             exit(20);
         }
+
+        if (save_state){
+            if (!S.saveState(save_state))
+                printf("ERROR! Could not save solver state: %s\n", (const char*)save_state), exit(1);
+            if (S.verbosity > 0)
+                printStats(S);
+            exit(0);
+        }
         
         vec<Lit> dummy;
-        lbool ret = S.solveLimited(dummy);
+        lbool   ret;
+        bool    proved = true;  // Whether the proof of an UNSAT answer is in 'W' rather than in those of the cubes.
+        if (cubes > 0){
+            // -- the driver waits for its workers and cannot be interrupted, the workers get the signal as well
+            signal(SIGINT, SIGINT_exit);
+            signal(SIGXCPU,SIGINT_exit);
+            CubeAndConquer C(S, cubes, cube_budget);
+            C.command   = cube_cmd;
+            C.state     = cube_state;
+            C.proof_dir = cube_proofs;
+            ret    = C.solve();
+            proved = C.cubes == 0;
+            if (S.verbosity > 0 && !proved)
+                printf("cubes                 : %-12d   (%d refuted, %d pruned, %d split)\n", C.cubes, C.refuted, C.pruned, C.splits);
+        }else
+            ret = P.solveLimited(dummy);
+        Solver& W   = cubes > 0 ? S : P.winner();
+        solver      = &W;
+        W.verbosity = S.verbosity;
         if (S.verbosity > 0){
-            printStats(S);
+            printStats(W);
             printf("\n"); }
         printf(ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
-        if (ret == l_False && S.proofLogging ()) printf ("%s\n", S.validate () ? "VALID" : "INVALID");
-        if (ret == l_False && S.proofLogging () && tcpf)
-        {
-          FILE *f = fopen ((const char*) tcpf, "w");
-          TraceProofVisitor v(S, f);
-          S.replay (v);
-          fclose (f);
-        }
+        if (ret == l_False && W.proofLogging () && proved) printf ("%s\n", W.validate () ? "VALID" : "INVALID");
+        if (ret == l_False && W.proofLogging () && proved && tcpf)
+          writeTrace(W, tcpf, tcpf_bin, tcpf_gz);
         if (res != NULL){
             if (ret == l_True){
                 fprintf(res, "SAT\n");
-                for (int i = 0; i < S.nVars(); i++)
-                    if (S.model[i] != l_Undef)
-                        fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
+                for (int i = 0; i < W.nVars(); i++)
+                    if (W.model[i] != l_Undef)
+                        fprintf(res, "%s%s%d", (i==0)?"":" ", (W.model[i]==l_True)?"":"-", i+1);
                 fprintf(res, " 0\n");
             }else if (ret == l_False)
                 fprintf(res, "UNSAT\n");
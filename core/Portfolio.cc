@@ -0,0 +1,229 @@
+#include "core/Portfolio.h"
+
+#include <string.h>
+
+#include <thread>
+
+using namespace Minisat;
+
+//=================================================================================================
+// ClauseExchange:
+//
+// A ring is written like a sequence lock: the writer first claims the words it is about to
+// overwrite, and a reader that finds them claimed after it has read a clause drops the clause.
+
+
+ClauseExchange::ClauseExchange(int nsolvers, int ring_words)
+{
+    int n = 1;
+    while (n < ring_words) n <<= 1;
+    mask = n - 1;
+
+    for (int i = 0; i < nsolvers; i++) rings.push_back(new Ring(n));
+    read.growTo(nsolvers);
+    for (int i = 0; i < nsolvers; i++) read[i].growTo(nsolvers, 0);
+    next.growTo(nsolvers, 0);
+}
+
+
+ClauseExchange::~ClauseExchange()
+{
+    for (size_t i = 0; i < rings.size(); i++) delete rings[i];
+}
+
+
+void ClauseExchange::push(int from, const vec<Lit>& c, Range part)
+{
+    Ring&    r   = *rings[from];
+    uint64_t pos = r.head.load(std::memory_order_relaxed);
+    uint64_t end = pos + c.size() + 2;
+    uint32_t p;
+    assert(end - pos <= mask + 1);
+    memcpy(&p, &part, sizeof(p));
+
+    r.claim.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    r.words[pos & mask].store(c.size(), std::memory_order_relaxed);
+    r.words[(pos + 1) & mask].store(p, std::memory_order_relaxed);
+    for (int i = 0; i < c.size(); i++)
+        r.words[(pos + 2 + i) & mask].store(toInt(c[i]), std::memory_order_relaxed);
+    r.head.store(end, std::memory_order_release);
+}
+
+
+bool ClauseExchange::pull(int to, vec<Lit>& c, Range& part)
+{
+    int n = rings.size();
+    for (int k = 0; k < n; k++){
+        int from = (next[to] + k) % n;
+        if (from == to) continue;
+
+        Ring&     r    = *rings[from];
+        uint64_t& pos  = read[to][from];
+        uint64_t  head = r.head.load(std::memory_order_acquire);
+        if (pos == head) continue;
+
+        // -- lapped by the writer, the clauses in between are lost
+        if (head - pos > mask + 1){
+            pos = head;
+            continue; }
+
+        uint32_t size = r.words[pos & mask].load(std::memory_order_relaxed);
+        uint32_t p    = r.words[(pos + 1) & mask].load(std::memory_order_relaxed);
+        if (size + 2 > head - pos){
+            pos = head;
+            continue; }
+        c.clear();
+        for (uint32_t i = 0; i < size; i++)
+            c.push(toLit(r.words[(pos + 2 + i) & mask].load(std::memory_order_relaxed)));
+
+        // -- overwritten while it was read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (r.claim.load(std::memory_order_relaxed) - pos > mask + 1){
+            pos = r.head.load(std::memory_order_acquire);
+            continue; }
+
+        pos     += size + 2;
+        next[to] = (from + 1) % n;
+        memcpy(&part, &p, sizeof(p));
+        return true;
+    }
+    return false;
+}
+
+
+//=================================================================================================
+// Portfolio:
+
+
+Portfolio::Portfolio(Solver& first, int n, int share_lim) : exchange(NULL), won(-1)
+{
+    solvers.push(&first);
+    for (int i = 1; i < n; i++){
+        Solver* s = new Solver();
+        s->log_proof         = first.log_proof;
+        s->ordered_propagate = first.ordered_propagate;
+
+        // -- diversification, the random initial activities make the seeds matter from the start
+        s->random_seed   = first.random_seed + 1000003.0 * i;
+        s->rnd_init_act  = true;
+        s->luby_restart  = i % 2 == 0 ? first.luby_restart : !first.luby_restart;
+        s->phase_saving  = (first.phase_saving + i) % 3;
+        s->restart_first = i % 3 == 0 ? first.restart_first : i % 3 == 1 ? first.restart_first / 2 + 1 : first.restart_first * 2;
+        solvers.push(s);
+    }
+
+    if (n > 1 && share_lim > 0){
+        exchange = new ClauseExchange(n, 1 << 20);
+        for (int i = 0; i < n; i++){
+            solvers[i]->exchange    = exchange;
+            solvers[i]->exchange_id = i;
+            solvers[i]->share_lim   = share_lim; }
+    }
+}
+
+
+Portfolio::~Portfolio()
+{
+    solvers[0]->exchange = NULL;
+    for (int i = 1; i < solvers.size(); i++) delete solvers[i];
+    delete exchange;
+}
+
+
+Var Portfolio::newVar(bool polarity, bool dvar)
+{
+    Var v = solvers[0]->newVar(polarity, dvar);
+    for (int i = 1; i < solvers.size(); i++) solvers[i]->newVar(polarity, dvar);
+    return v;
+}
+
+
+bool Portfolio::addClause_(vec<Lit>& ps)
+{
+    bool ok = true;
+    for (int i = 1; i < solvers.size(); i++){
+        ps.copyTo(add_tmp);
+        ok &= solvers[i]->addClause_(add_tmp); }
+    ok &= solvers[0]->addClause_(ps);
+    return ok;
+}
+
+
+void Portfolio::setCurrentPart(unsigned n)
+{
+    for (int i = 0; i < solvers.size(); i++) solvers[i]->setCurrentPart(n);
+}
+
+
+void Portfolio::beginClauses(int n, uint64_t lits)
+{
+    for (int i = 0; i < solvers.size(); i++) solvers[i]->beginClauses(n, lits);
+}
+
+
+bool Portfolio::commitClauses()
+{
+    bool ok = true;
+    for (int i = 0; i < solvers.size(); i++) ok &= solvers[i]->commitClauses();
+    return ok;
+}
+
+
+bool Portfolio::loadState(const char* file)
+{
+    // -- every solver maps the same arena, so that its pages are shared until they are written
+    bool ok = true;
+    for (int i = 0; i < solvers.size() && ok; i++) ok = solvers[i]->loadState(file);
+    return ok;
+}
+
+
+bool Portfolio::simplify()
+{
+    bool ok = true;
+    for (int i = 0; i < solvers.size(); i++) ok &= solvers[i]->simplify();
+    return ok;
+}
+
+
+void Portfolio::interrupt()
+{
+    for (int i = 0; i < solvers.size(); i++) solvers[i]->interrupt();
+}
+
+
+void Portfolio::run(int i, const vec<Lit>* assumps, lbool* result, std::atomic<int>* first)
+{
+    *result = solvers[i]->solveLimited(*assumps);
+
+    int none = -1;
+    if (*result != l_Undef && first->compare_exchange_strong(none, i))
+        for (int j = 0; j < solvers.size(); j++)
+            if (j != i) solvers[j]->interrupt();
+}
+
+
+lbool Portfolio::solveLimited(const vec<Lit>& assumps)
+{
+    won = -1;
+    if (solvers.size() == 1){
+        won = 0;
+        return solvers[0]->solveLimited(assumps); }
+
+    vec<lbool>               results(solvers.size(), l_Undef);
+    std::atomic<int>         first(-1);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < solvers.size(); i++)
+        threads.push_back(std::thread(&Portfolio::run, this, i, &assumps, &results[i], &first));
+    run(0, &assumps, &results[0], &first);
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+    if (first.load() < 0) return l_Undef;
+
+    // -- the others were interrupted by the winner
+    won = first.load();
+    for (int i = 0; i < solvers.size(); i++)
+        if (i != won) solvers[i]->clearInterrupt();
+    return results[won];
+}
@@ -0,0 +1,98 @@
+#ifndef Minisat_Portfolio_h
+#define Minisat_Portfolio_h
+
+#include <atomic>
+#include <vector>
+
+#include "core/Solver.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// ClauseExchange -- short learnt clauses passed between the solvers of a portfolio:
+//
+// Every solver writes to a ring of its own and reads the rings of all others, without locks. A
+// reader that the writer has lapped skips to the newest clause, and a clause that was overwritten
+// while it was read is dropped. A clause is its size, its partition and its literals.
+
+
+class ClauseExchange {
+ public:
+    ClauseExchange(int nsolvers, int ring_words);
+    ~ClauseExchange();
+
+    void    push (int from, const vec<Lit>& c, Range part);  // Offer a clause of solver 'from' to the others.
+    bool    pull (int to,   vec<Lit>& c, Range& part);       // Next clause of another solver for 'to', false if there is none.
+
+ private:
+    struct Ring {
+        std::vector<std::atomic<uint32_t> > words;
+        std::atomic<uint64_t>               head;       // Number of words written so far.
+        std::atomic<uint64_t>               claim;      // Number of words written once the current write is done.
+        Ring(int n) : words(n), head(0), claim(0) {}
+    };
+
+    std::vector<Ring*> rings;
+    vec<vec<uint64_t> > read;                           // 'read[to][from]' is the position of 'to' in the ring of 'from'.
+    vec<int>            next;                           // Ring that 'to' reads from first the next time.
+    uint64_t            mask;
+
+    // Not copyable:
+    ClauseExchange(const ClauseExchange&);
+    ClauseExchange& operator=(const ClauseExchange&);
+};
+
+
+//=================================================================================================
+// Portfolio -- several diversified solvers searching the same problem in parallel:
+//
+// The problem is given to every solver. Each solver runs in a thread of its own and exports its
+// learnt clauses of at most 'share_lim' literals, importing those of the others at restarts. The
+// first solver to finish interrupts the others and becomes the winner, whose model, conflict and
+// proof answer the query. Solver 0 is the one the portfolio was created with and keeps its
+// parameters, the others vary the random seed, restarts and phase saving.
+
+
+class Portfolio {
+ public:
+    Portfolio(Solver& first, int n, int share_lim);
+    ~Portfolio();
+
+    int      size   ()      const { return solvers.size(); }
+    Solver&  solver (int i)       { return *solvers[i]; }
+    Solver&  winner ()            { return *solvers[won < 0 ? 0 : won]; } // The solver that answered the last query.
+
+    // Problem specification, as for a single solver (so that 'parse_DIMACS()' can fill a portfolio):
+    //
+    int      nVars         ()      const { return solvers[0]->nVars(); }
+    Var      newVar        (bool polarity = true, bool dvar = true);
+    bool     addClause_    (vec<Lit>& ps);
+    void     setCurrentPart(unsigned n);
+    unsigned getCurrentPart()            { return solvers[0]->getCurrentPart(); }
+    void     beginClauses  (int n, uint64_t lits);
+    bool     commitClauses ();
+    bool     loadState     (const char* file);
+
+    // Solving:
+    //
+    bool     simplify      ();
+    lbool    solveLimited  (const vec<Lit>& assumps);
+    void     interrupt     ();
+
+ private:
+    vec<Solver*>     solvers;
+    ClauseExchange*  exchange;
+    int              won;
+    vec<Lit>         add_tmp;
+
+    void     run           (int i, const vec<Lit>* assumps, lbool* result, std::atomic<int>* first);
+
+    // Not copyable:
+    Portfolio(const Portfolio&);
+    Portfolio& operator=(const Portfolio&);
+};
+
+//=================================================================================================
+}
+
+#endif
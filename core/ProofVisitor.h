@@ -14,6 +14,25 @@
 
 namespace Minisat {
 
+  /// A resolution step of a replayed proof. The antecedents are spans into
+  /// memory of the solver, they are only valid during the visitor call.
+  ///
+  /// 'clauses [0]' is the first antecedent, and 'clauses [i+1]' is resolved
+  /// with it on 'pivots [i]'. If 'i+1 >= nClauses' or 'clauses [i+1]' is
+  /// CRef_Undef, the unit 'pivots [i]' of level 0 is resolved instead.
+  struct ProofStep
+  {
+    enum Kind { Resolvent, ChainLit, ChainClause };
+
+    Kind        kind;
+    Lit         lit;        // -- the resolvent of Resolvent and ChainLit steps
+    CRef        clause;     // -- the resolvent of ChainClause steps, CRef_Undef for the empty clause
+    const Lit  *pivots;
+    int         nPivots;
+    const CRef *clauses;
+    int         nClauses;
+  };
+
   class ProofVisitor
   {
   public:
@@ -24,8 +43,52 @@ namespace Minisat {
     virtual int visitChainResolvent (Lit parent)                  { return 0; }
     virtual int visitChainResolvent (CRef parent)                 { return 0; }
 
+    /// -- visits 'n' consecutive steps, e.g., a whole chain or a whole
+    /// -- pass of labelLevel0 (). By default each step is forwarded to the
+    /// -- callbacks above through 'chainPivots' and 'chainClauses'.
+    virtual int visitSteps (const ProofStep *steps, int n)
+    {
+      for (int i = 0; i < n; ++i) forwardStep (steps [i]);
+      return 0;
+    }
+
     vec<Lit>        chainPivots;
     vec<CRef>       chainClauses;
+
+  protected:
+    void forwardStep (const ProofStep &s)
+    {
+      if (s.kind == ProofStep::Resolvent)
+      {
+        visitResolvent (s.lit, s.pivots [0], s.clauses [0]);
+        return;
+      }
+
+      chainPivots.clear ();
+      chainClauses.clear ();
+      for (int i = 0; i < s.nPivots; ++i) chainPivots.push (s.pivots [i]);
+      for (int i = 0; i < s.nClauses; ++i) chainClauses.push (s.clauses [i]);
+      while (chainClauses.size () <= s.nPivots) chainClauses.push (CRef_Undef);
+
+      if (s.kind == ProofStep::ChainLit) visitChainResolvent (s.lit);
+      else visitChainResolvent (s.clause);
+    }
+  };
+
+  /// Base of visitors that handle the steps of a batch without virtual
+  /// dispatch. 'Derived' provides 'int visitStep (const ProofStep &s)',
+  /// which is bound at compile time in the loop over each batch, so the
+  /// solver makes one virtual call per batch instead of one per step.
+  template<class Derived>
+  class StaticProofVisitor : public ProofVisitor
+  {
+  public:
+    int visitSteps (const ProofStep *steps, int n)
+    {
+      Derived &d = static_cast<Derived&> (*this);
+      for (int i = 0; i < n; ++i) d.visitStep (steps [i]);
+      return 0;
+    }
   };
 }
 
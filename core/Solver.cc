@@ -25,10 +25,28 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "mtl/Sort.h"
 #include "core/Solver.h"
 #include "core/ProofVisitor.h"
+#include "core/LemmaChecker.h"
+#include "core/StateFile.h"
+#include "core/Portfolio.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <set>
+#include <thread>
+#include <vector>
 using namespace Minisat;
 
+namespace
+{
+  void runLemmaChecker (ProofTable* t, int id, int nthreads, int chunk)
+  {
+    LemmaChecker (*t, id, nthreads, chunk).run ();
+  }
+}
+
 //=================================================================================================
 // Options:
 
@@ -43,11 +61,20 @@ static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls confl
 static IntOption     opt_phase_saving      (_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the initial activity", false);
 static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby restart sequence", true);
+static BoolOption    opt_vmtf              (_cat, "vmtf",        "Decide on the most recently bumped variable (VMTF) instead of the most active one (VSIDS)", false);
+static DoubleOption  opt_part_bias         (_cat, "part-bias",   "Scale the activity bumps of a variable by this factor per partition above the first (1=off)", 1, DoubleRange(0, false, 1, true));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Keep the assumptions assigned across restarts and the assumptions shared with the next solve", true);
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
+static IntOption     opt_core_lbd          (_cat, "core-lbd",    "Never remove learnt clauses of at most this LBD", 2, IntRange(0, INT32_MAX));
+static IntOption     opt_tier2_lbd         (_cat, "tier2-lbd",   "Keep learnt clauses of at most this LBD while they take part in conflicts", 6, IntRange(0, INT32_MAX));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.2 , DoubleRange(0, false, HUGE_VAL, false));
 
 static BoolOption    opt_valid             (_cat, "valid",    "Validate UNSAT answers", true);
+static BoolOption    opt_proof_spill       (_cat, "proof-spill", "Move deleted proof clauses to a temporary file during garbage collection", false);
+static BoolOption    opt_proof_trim        (_cat, "proof-trim", "Drop deleted proof clauses that are not needed by later validations after each validation", false);
+static BoolOption    opt_valid_incr        (_cat, "valid-incr", "Validate only the proof steps added since the previous validation", false);
+static IntOption     opt_valid_threads     (_cat, "valid-threads", "Number of threads that check lemmas during validation", 1, IntRange(1, 1024));
 
 
 //=================================================================================================
@@ -60,7 +87,14 @@ Solver::Solver() :
     //
     verbosity        (0)
   , log_proof (opt_valid)
+  , proof_spill (opt_proof_spill)
+  , proof_trim (opt_proof_trim)
+  , valid_incr (opt_valid_incr)
+  , valid_threads (opt_valid_threads)
   , ordered_propagate (false)
+  , exchange         (NULL)
+  , exchange_id      (0)
+  , share_lim        (0)
   , var_decay        (opt_var_decay)
   , clause_decay     (opt_clause_decay)
   , random_var_freq  (opt_random_var_freq)
@@ -70,7 +104,12 @@ Solver::Solver() :
   , phase_saving     (opt_phase_saving)
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
+  , vmtf             (opt_vmtf)
+  , part_bias        (opt_part_bias)
+  , reuse_trail      (opt_reuse_trail)
   , garbage_frac     (opt_garbage_frac)
+  , core_lbd         (opt_core_lbd)
+  , tier2_lbd        (opt_tier2_lbd)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
 
@@ -89,15 +128,31 @@ Solver::Solver() :
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
 
   , ok                 (true)
+  , learnts_core       (0)
   , cla_inc            (1)
   , var_inc            (1)
+  , spill_file         (NULL)
+  , valid_lim          (0)
+  , walk_pos           (-1)
+  , walk_walked        (0)
+  , walk_lim           (0)
+  , replay_pos         (-1)
+  , fix_cache          (-1)
   , watches            (WatcherDeleted(ca))
+  , watches_ordered    (false)
   , qhead              (0)
+  , bulk_clauses       (-1)
+  , bulk_trail         (0)
   , simpDB_assigns     (-1)
   , simpDB_props       (0)
   , order_heap         (VarOrderLt(activity))
+  , vmtf_first         (var_Undef)
+  , vmtf_last          (var_Undef)
+  , vmtf_search        (var_Undef)
+  , vmtf_stamp         (0)
   , progress_estimate  (0)
   , remove_satisfied   (true)
+  , lbd_stamp          (0)
 
     // Resource constraints:
     //
@@ -115,6 +170,7 @@ Solver::Solver() :
 
 Solver::~Solver()
 {
+    if (spill_file != NULL) fclose(spill_file);
 }
 
 
@@ -156,185 +212,485 @@ void Solver::runProof()
 	start = 0;
 }
 
-bool Solver::validate ()
+/*_________________________________________________________________________________________________
+|
+|  validate_ : (budgeted : bool)  ->  [lbool]
+|
+|  Description:
+|    Validates the proof (see 'validateSteps()'). If 'budgeted' is set, the validation stops once
+|    the propagation budget is used up or the solver is interrupted, and returns l_Undef. It goes on
+|    from where it stopped when it is called again. In between, the solver must not be used for
+|    anything else. Returns l_True if the proof is valid and l_False if it is not.
+|________________________________________________________________________________________________@*/
+lbool Solver::validate_ (bool budgeted)
 {
+  PhaseTimer timer (stat, phase_Validate);
+  cancelUntil (0);
   assert (log_proof);
-  assert (!ok || confl_assumps != CRef_Undef);
   assert (proof.size () > 0);
 
-  // If DB was solved under assumptions and multiple assumptions
-  // are the reason for unsatisfiability, then add them as a new
-  // learn clause, and mark this situation by
-  //
-  if (confl_assumps != CRef_Undef) {
-      Clause& c = ca[confl_assumps];
-      if (c.size() > 1) {
-          attachClause(confl_assumps);
-          learnts.push(confl_assumps);
-          proof.push(0);
+  scopped_ordered_propagate scp_propagate (*this, true);
+
+  if (walk_pos < 0)
+    {
+      assert (!ok || confl_assumps != CRef_Undef);
+
+      // If DB was solved under assumptions and multiple assumptions
+      // are the reason for unsatisfiability, then add them as a new
+      // learn clause, and mark this situation by
+      //
+      if (confl_assumps != CRef_Undef) {
+          Clause& c = ca[confl_assumps];
+          if (c.size() > 1) {
+              attachClause(confl_assumps);
+              learnts.push(confl_assumps);
+              proof.push(0);
+          }
       }
-  }
 
-  scopped_ordered_propagate scp_propagate (*this, true);
+      // -- final conflict clause is in the core
+      // If the last clause is 0, or the final conflict under assumptions
+      // contains only one literal, mark all reasons.
+      if (proof.last () != 0 ||
+          (confl_assumps != CRef_Undef && ca[confl_assumps].size() == 1)) {
+          Clause &last = (proof.last() == 0) ? ca[confl_assumps] : ca [proof.last ()];
+          last.core (1);
+          // -- mark all reasons for the final conflict as core
+          for (int i = 0; i < last.size (); i++)
+            {
+                // -- validate that the clause is really a conflict clause
+                //if (value (last [i]) != l_False) return false;
+                Var x = var (last [i]);
+                if (reason(x) != CRef_Undef) ca [reason (x)].core (1);
+            }
+      }
+      else
+          ca[proofStep(proof.size()-2)].core(1);
+    }
 
-  // -- final conflict clause is in the core
-  // If the last clause is 0, or the final conflict under assumptions
-  // contains only one literal, mark all reasons.
-  if (proof.last () != 0 ||
-      (confl_assumps != CRef_Undef && ca[confl_assumps].size() == 1)) {
-      Clause &last = (proof.last() == 0) ? ca[confl_assumps] : ca [proof.last ()];
-      last.core (1);
-      // -- mark all reasons for the final conflict as core
-      for (int i = 0; i < last.size (); i++)
-        {
-            // -- validate that the clause is really a conflict clause
-            //if (value (last [i]) != l_False) return false;
-            Var x = var (last [i]);
-            if (reason(x) != CRef_Undef) ca [reason (x)].core (1);
-        }
-  }
-  else
-      ca[proof[proof.size()-2]].core(1);
+  // -- a database that is unsatisfiable without assumptions will not be solved again
+  bool  restore = valid_incr && confl_assumps != CRef_Undef;
+  lbool res     = validateSteps (restore ? valid_lim : 0, restore, budgeted);
+  if (res != l_True) return res;
+  if (verbosity >= 1) printf ("VALIDATED\n");
+
+  // -- the core is known now, reclaim the lemmas that can not be needed any more
+  if (proof_trim)
+    {
+      trimProof ();
+      garbageCollect ();
+    }
+  return l_True;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  validateSteps : (lim : int) (restore : bool) (budgeted : bool)  ->  [lbool]
+|
+|  Description:
+|    Moves back through the proof from its end down to step 'lim', shrinking the trail and
+|    validating the core lemmas that were not validated before. Lemmas below 'lim' that became
+|    core on the way are validated as well, so the walk continues below 'lim' while there are any.
+|    If 'restore' is set, the walked steps are then applied again so that the database is as it
+|    was before the call and solving can go on. The steps that were checked become the new
+|    checkpoint 'valid_lim'.
+|
+|    If 'budgeted' is set, the walk stops between two steps once the budget is used up, and
+|    returns l_Undef. The next call continues it, whatever its arguments. A budgeted walk checks
+|    the lemmas one at a time, as the parallel check would go over all of them at once.
+|________________________________________________________________________________________________@*/
+lbool Solver::validateSteps (int lim, bool restore, bool budgeted)
+{
+  scopped_ordered_propagate scp_propagate (*this, true);
 
   cancelUntil(0);
   int trail_sz = trail.size ();
   ok = true;
 
+  // -- a walk that ran out of budget goes on where it stopped
+  bool resume = walk_pos >= 0;
+  int  i, walked;
+  if (resume)
+    i = walk_pos, walked = walk_walked, lim = walk_lim, walk_pos = -1;
+
+  // -- check the lemmas in parallel, the walk below only marks their antecedents
+  ProofTable checked;
+  if (!resume && !budgeted && valid_threads > 1) checkLemmas (lim, checked);
+
   // -- move back through the proof, shrinking the trail and
   // -- validating the clauses
-  for (int i = proof.size () - 2; i >= 0; i--)
+  if (!resume)
     {
-      if (verbosity >= 2) fflush (stdout);
-      CRef cr = proof [i];
-      assert (cr != CRef_Undef);
-      Clause &c = ca [cr];
+      i = proof.size () - 2;
+      walked = i + 1;
+      if (stats_enabled) stat.proof_steps = proof.size (), stat.proof_lemmas = stat.core_lemmas = 0;
+    }
+  for (;;)
+  {
+    for (; i >= lim; i--)
+      {
+        if (budgeted && !withinBudget ())
+          {
+            // -- put the trail in a good state, and remember where to go on
+            trail.shrink (trail.size () - trail_sz);
+            qhead = trail.size ();
+            walk_pos = i, walk_walked = walked, walk_lim = lim;
+            return l_Undef;
+          }
+        if (verbosity >= 2) fflush (stdout);
+        CRef cr = proofStep (i);
+        assert (cr != CRef_Undef);
+        Clause &c = ca [cr];
 
-      //if (verbosity >= 2) printf ("Validating lemma #%d ... ", i);
+        //if (verbosity >= 2) printf ("Validating lemma #%d ... ", i);
 
-      // -- resurect deleted clauses
-      if (c.mark () == 1)
-        {
-          watches.cleanAll();
-          // -- undelete
-          c.mark (0);
-          Var x = var (c[0]);
+        // -- resurect deleted clauses
+        if (c.mark () == 1)
+          {
+            watches.cleanAll();
+            // -- undelete
+            c.mark (0);
+            Var x = var (c[0]);
 
-          // If satisfied, check that undef lits are at c[1]
-          if (satisfied(c) && c.size() > 1)
+            // If satisfied, check that undef lits are at c[1]
+            if (satisfied(c) && c.size() > 1)
+            {
+              for (int k=1; k < c.size() && value(c[1]) != l_Undef; k++)
+                  if (value(c[k]) == l_Undef){
+                      Lit l = c[1];
+                      c[1] = c[k], c[k] = l;
+                  }
+            }
+            // -- if non-unit clause, attach it
+            if (c.size () > 1) attachClause (cr);
+            else // -- if unit clause, enqueue it
+              {
+                bool res = enqueue (c[0], cr);
+                assert (res);
+              }
+            if (verbosity >= 2) printf ("^");
+            continue;
+          }
+        assert (c.mark () == 0);
+        // -- detach the clause
+        if (locked (c))
           {
-            for (int k=1; k < c.size() && value(c[1]) != l_Undef; k++)
-                if (value(c[k]) == l_Undef){
-                    Lit l = c[1];
-                    c[1] = c[k], c[k] = l;
-                }
+            if (core_units) c.core(1);
+            // -- undo the bcp
+            while (trail[trail_sz - 1] != c[0])
+              {
+                assert(trail_sz > 0);
+                Var x = var (trail [trail_sz - 1]);
+                assigns [x] = l_Undef;
+                insertVarOrder (x);
+                trail_sz--;
+
+                CRef r = reason (x);
+                assert (r != CRef_Undef);
+                // -- mark literals of core clause as core
+                if (core_units) ca[r].core(1);
+                if (ca [r].core ())
+                  {
+                    Clause &rc = ca [r];
+                    for (int j = 1; j < rc.size (); ++j)
+                      {
+                        Var x = var (rc [j]);
+                        assert(reason(x) != CRef_Undef);
+                        ca [reason (x)].core (1);
+                      }
+                  }
+              }
+            assert (c[0] == trail [trail_sz - 1]);
+            // -- unassign the variable
+            assigns [var (c[0])] = l_Undef;
+            // -- put it back in order heap in case we want to restart
+            // -- solving in the future
+            insertVarOrder (var (c[0]));
+            trail_sz--;
           }
-          // -- if non-unit clause, attach it
-          if (c.size () > 1) attachClause (cr);
-          else // -- if unit clause, enqueue it
+        // -- unit clauses don't need to be detached from watched literals
+        if (c.size () > 1) detachClause (cr);
+        // -- mark clause deleted
+        c.mark (1);
+        if (stats_enabled && c.learnt ())
+          {
+            stat.proof_lemmas++;
+            if (c.core ()) stat.core_lemmas++;
+          }
+        if (c.core () == 1 && (i >= valid_done.size () || !valid_done [i]))
+          {
+            assert (value (c[0]) == l_Undef);
+            // -- put trail in a good state
+            trail.shrink (trail.size () - trail_sz);
+            qhead = trail.size ();
+            if (trail_lim.size () > 0) trail_lim [0] = trail.size ();
+            if (verbosity >= 2) printf ("V");
+            bool valid = i < checked.status.size () && checked.status [i] == ProofTable::Valid &&
+                         markAntecedents (checked, i);
+            if (!valid && !validateLemma (cr))
             {
-              bool res = enqueue (c[0], cr);
-              assert (res);
+                printf("Failed for i=%d and %d...\n", i, proof[i]);
+          	  return l_False;
             }
-          if (verbosity >= 2) printf ("^");
-          continue;
+          }
+        else if (verbosity >= 2) printf ("-");
+
+        // -- the clause is not needed by validation any more, drop it if it is on disk
+        pageOut (i);
+        // -- reclaim dropped clauses while the trail is consistent
+        if (proof_spill && trail.size () == trail_sz) checkGarbage ();
+      }
+    if (i + 1 < walked) walked = i + 1;
+
+    // update trail and qhead
+    trail.shrink (trail.size () - trail_sz);
+    qhead = trail.size ();
+    if (trail_lim.size () > 0) trail_lim [0] = trail.size ();
+
+    // find core clauses in the rest of the trail
+    for (int j = trail.size () - 1; j >= 0; --j)
+      {
+        assert (reason (var (trail [j])) != CRef_Undef);
+        Clause &c = ca [reason (var (trail [j]))];
+        // -- if c is core, mark all clauses it depends as core
+        if (c.core () == 1) {
+          for (int k = 1; k < c.size (); ++k)
+            {
+              Var x = var (c[k]);
+              ca[reason (x)].core (1);
+            }
+          qhead = j;
         }
-      assert (c.mark () == 0);
-      // -- detach the clause
-      if (locked (c))
+
+      }
+
+    if (!restore) break;
+    // -- continue down to the next lemma before the checkpoint that joined the core
+    for (lim = i; lim >= 0 && !pendingLemma (lim); lim--);
+    if (lim < 0) break;
+  }
+  if (verbosity >= 2) printf ("\n");
+
+  // Put units back on the trail, except for lemmas of the simplifier that the walk took back
+  for (int i=0; i < clauses.size(); i++) {
+      Clause& c = ca[clauses[i]];
+      if (c.size() == 1 && c.mark() == 0)
+          enqueue(c[0], clauses[i]);
+  }
+
+  watches.cleanAll();
+  assignParts(); // FS
+  if (restore) restoreSteps (walked);
+  else         valid_lim = 0, valid_done.clear ();
+  return l_True;
+}
+
+
+bool Solver::pendingLemma (int i)
+{
+  const Clause *c = &ca [proof [i]];
+  // -- a spilled clause that is paged in carries its flags in the copy
+  if (c->spilled () && spill_cref [toInt ((*c)[0])] != CRef_Undef)
+    c = &ca [spill_cref [toInt ((*c)[0])]];
+  return c->learnt () && c->core () && (i >= valid_done.size () || !valid_done [i]);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  restoreSteps : (from : int)  ->  [void]
+|
+|  Description:
+|    Applies the proof steps from 'from' on again after 'validateSteps()' moved back over them:
+|    lemmas are attached and deleted clauses are detached, and the trail is propagated again.
+|    Records which of these steps are core lemmas, i.e., validated, and moves the checkpoint to
+|    the end of the proof.
+|________________________________________________________________________________________________@*/
+void Solver::restoreSteps (int from)
+{
+  int end = proof.size () - 1;
+  if (valid_done.size () > end) valid_done.shrink (valid_done.size () - end);
+  valid_done.growTo (end, 0);
+
+  for (int i = from; i < end; i++)
+    {
+      CRef cr = proofStep (i);
+      Clause &c = ca [cr];
+      valid_done [i] = c.learnt () && c.core ();
+      // -- validation moved back over a step by flipping the mark of its clause
+      if (c.mark () == 1)
         {
-          if (core_units) c.core(1);
-          // -- undo the bcp
-          while (trail[trail_sz - 1] != c[0])
+          c.mark (0);
+          if (c.size () > 1) attachClause (cr);
+          else
             {
-              assert(trail_sz > 0);
-              Var x = var (trail [trail_sz - 1]);
-              assigns [x] = l_Undef;
-              insertVarOrder (x);
-              trail_sz--;
-
-              CRef r = reason (x);
-              assert (r != CRef_Undef);
-              // -- mark literals of core clause as core
-              if (core_units) ca[r].core(1);
-              if (ca [r].core ())
-                {
-                  Clause &rc = ca [r];
-                  for (int j = 1; j < rc.size (); ++j)
-                    {
-                      Var x = var (rc [j]);
-                      assert(reason(x) != CRef_Undef);
-                      ca [reason (x)].core (1);
-                    }
-                }
+              bool res = enqueue (c[0], cr);
+              assert (res);
             }
-          assert (c[0] == trail [trail_sz - 1]);
-          // -- unassign the variable
-          assigns [var (c[0])] = l_Undef;
-          // -- put it back in order heap in case we want to restart
-          // -- solving in the future
-          insertVarOrder (var (c[0]));
-          trail_sz--;
         }
-      // -- unit clauses don't need to be detached from watched literals
-      if (c.size () > 1) detachClause (cr);
-      // -- mark clause deleted
-      c.mark (1);
-      if (c.core () == 1)
+      else
         {
-          assert (value (c[0]) == l_Undef);
-          // -- put trail in a good state
-          trail.shrink (trail.size () - trail_sz);
-          qhead = trail.size ();
-          if (trail_lim.size () > 0) trail_lim [0] = trail.size ();
-          if (verbosity >= 2) printf ("V");
-          if (!validateLemma (cr))
-          {
-              printf("Failed for i=%d and %d...\n", i, proof[i]);
-        	  return false;
-          }
+          if (c.size () > 1) detachClause (cr);
+          c.mark (1);
+          pageOut (i);
         }
-      else if (verbosity >= 2) printf ("-");
-
+    }
+  watches.cleanAll ();
 
+  // -- the units of the restored clauses, and watches that went stale while they were detached
+  qhead = 0;
+  CRef confl = propagate ();
+  if (confl != CRef_Undef)
+    {
+      proof.push (confl);
+      ok = false;
     }
-  if (verbosity >= 2) printf ("\n");
+  valid_lim = end;
+}
 
+/*_________________________________________________________________________________________________
+|
+|  checkLemmas : (from : int) (t : ProofTable&)  ->  [void]
+|
+|  Description:
+|    Copies the proof into 't' and checks the lemmas of the steps from 'from' on with
+|    'valid_threads' threads. Each thread builds its own database by going forward through the
+|    proof and checks every 'valid_threads'th chunk of the lemmas. All lemmas are checked, since
+|    the core is only known once the backward walk of 'validateSteps()' reaches them; the walk
+|    then uses the recorded antecedents instead of checking the core lemmas again.
+|________________________________________________________________________________________________@*/
+void Solver::checkLemmas (int from, ProofTable& t)
+{
+  int end = proof.size () - 1;
+  RefTable<CRef, int> ids (-1);
 
-  // update trail and qhead
-  trail.shrink (trail.size () - trail_sz);
-  qhead = trail.size ();
-  if (trail_lim.size () > 0) trail_lim [0] = trail.size ();
+  t.nvars = nVars ();
+  t.from  = from;
+  t.to    = end;
+  t.start.push (0);
 
-  // find core clauses in the rest of the trail
-  for (int i = trail.size () - 1; i >= 0; --i)
+  // -- the clauses of the database, and the clauses of the proof
+  vec<char> mark;
+  for (int i = 0; i < clauses.size (); i++)
     {
-      assert (reason (var (trail [i])) != CRef_Undef);
-      Clause &c = ca [reason (var (trail [i]))];
-      // -- if c is core, mark all clauses it depends as core
-      if (c.core () == 1) {
-        for (int j = 1; j < c.size (); ++j)
-          {
-            Var x = var (c[j]);
-            ca[reason (x)].core (1);
-          }
-        qhead = i;
-      }
+      const Clause &c = ca [clauses [i]];
+      ids.insert (clauses [i], t.nClauses ());
+      for (int j = 0; j < c.size (); j++) t.lits.push (c [j]);
+      t.start.push (t.lits.size ());
+      t.origin.push (i);
+      mark.push (c.mark ());
+    }
+  for (int i = 0; i < end; i++)
+    {
+      int id;
+      if (!ids.has (proof [i], id))
+        {
+          // -- a spilled clause is paged out again, unless validation already paged it in
+          bool spilled = ca [proof [i]].spilled () && spill_cref [toInt (ca [proof [i]][0])] == CRef_Undef;
+          const Clause &c = ca [proofStep (i)];
+          id = t.nClauses ();
+          ids.insert (proof [i], id);
+          for (int j = 0; j < c.size (); j++) t.lits.push (c [j]);
+          t.start.push (t.lits.size ());
+          t.origin.push (-i - 1);
+          mark.push (c.mark ());
+          if (spilled) pageOut (i);
+        }
+      t.step.push (id);
+    }
 
+  // -- like the walk of 'validateSteps()', take a step of a deleted clause for its deletion
+  // -- and any other step for a lemma, the clauses that are left make the initial database
+  t.add.growTo (end, 0);
+  for (int i = end - 1; i >= 0; i--)
+    {
+      t.add [i] = !mark [t.step [i]];
+      mark [t.step [i]] ^= 1;
     }
+  for (int c = 0; c < mark.size (); c++) t.initial.push (!mark [c]);
 
-  // Put units back on the trail
-  for (int i=0; i < clauses.size(); i++) {
-      Clause& c = ca[clauses[i]];
-      if (c.size() == 1)
-          enqueue(c[0], clauses[i]);
-  }
+  // -- the level 0 trail, and the prefix of it that is left at each step
+  t.unit_val.growTo (nVars (), l_Undef);
+  t.unit_pos.growTo (nVars (), INT32_MAX);
+  for (int i = 0; i < trail.size (); i++)
+    {
+      t.unit_val [var (trail [i])] = value (var (trail [i]));
+      t.unit_pos [var (trail [i])] = i;
+    }
+  t.unit_lim.growTo (end, 0);
+  int trail_sz = trail.size ();
+  for (int i = end - 1; i >= from; i--)
+    {
+      const Clause &c = ca [proof [i]];
+      if (t.add [i] && !c.spilled ())
+        {
+          Var x = var (c [0]);
+          if (reason (x) == proof [i] && t.unit_pos [x] < trail_sz) trail_sz = t.unit_pos [x];
+        }
+      t.unit_lim [i] = trail_sz;
+    }
 
-  watches.cleanAll();
-  if (verbosity >= 1) printf ("VALIDATED\n");
-  assignParts(); // FS
+  t.status.growTo (end, ProofTable::Unchecked);
+  t.owner .growTo (end, 0);
+  t.first .growTo (end, 0);
+  t.count .growTo (end, 0);
+  t.ante  .growTo (valid_threads);
+
+  // -- small chunks balance the load, every thread builds the whole database anyway
+  int chunk = std::max (1, (end - from) / (valid_threads * 16));
+  std::vector<std::thread> threads;
+  for (int i = 1; i < valid_threads; i++)
+    threads.push_back (std::thread (runLemmaChecker, &t, i, (int)valid_threads, chunk));
+  runLemmaChecker (&t, 0, valid_threads, chunk);
+  for (size_t i = 0; i < threads.size (); i++) threads [i].join ();
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  markAntecedents : (t : const ProofTable&) (i : int)  ->  [bool]
+|
+|  Description:
+|    Marks the antecedents that 'checkLemmas()' recorded for the lemma of step 'i' as core. Fails
+|    if a unit the check relied on is not on the trail any more; the lemma is then validated by
+|    'validateLemma()' instead.
+|________________________________________________________________________________________________@*/
+bool Solver::markAntecedents (const ProofTable& t, int i)
+{
+  const vec<int> &ante = t.ante [t.owner [i]];
+  int first = t.first [i], last = first + t.count [i];
+
+  for (int k = first; k < last; k++)
+    if (ProofTable::isUnit (ante [k]))
+      {
+        Var x = ProofTable::unitVar (ante [k]);
+        if (value (x) == l_Undef || reason (x) == CRef_Undef) return false;
+      }
+
+  for (int k = first; k < last; k++)
+    {
+      if (ProofTable::isUnit (ante [k]))
+        {
+          ca [reason (ProofTable::unitVar (ante [k]))].core (1);
+          continue;
+        }
+      int o = t.origin [ante [k]];
+      if (o >= 0)
+        {
+          ca [clauses [o]].core (1);
+          continue;
+        }
+      // -- the flags of a spilled clause are kept by its stub and by its paged in copy
+      Clause &c = ca [proof [-o - 1]];
+      c.core (1);
+      if (c.spilled () && spill_cref [toInt (c [0])] != CRef_Undef)
+        ca [spill_cref [toInt (c [0])]].core (1);
+    }
   return true;
 }
 
+
 bool Solver::validateLemma (CRef cr)
 {
   assert (decisionLevel () == 0);
@@ -416,29 +772,66 @@ bool Solver::validateLemma (CRef cr)
   return true;
 }
 
-void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
+/*_________________________________________________________________________________________________
+|
+|  replay_ : (v : ProofVisitor&) (pOldProof : vec<CRef>*) (budgeted : bool)  ->  [lbool]
+|
+|  Description:
+|    Replays the validated proof, handing its steps to 'v'. If 'budgeted' is set, the replay stops
+|    between two proof steps once the propagation budget is used up or the solver is interrupted,
+|    and returns l_Undef. It goes on from where it stopped when it is called again, with the same
+|    visitor. In between, the solver must not be used for anything else. Returns l_True once the
+|    proof is replayed.
+|________________________________________________________________________________________________@*/
+lbool Solver::replay_ (ProofVisitor& v, vec<CRef>* pOldProof, bool budgeted)
 {
+  PhaseTimer timer (stat, phase_Replay);
+  cancelUntil (0);
   assert (log_proof);
   assert (proof.size () > 0);
-  if (verbosity >= 2) printf ("REPLAYING: ");
 
   // -- enter ordered propagate mode
   scopped_ordered_propagate scp_propagate (*this, true);
 
-  CRef confl = propagate (true);
-  // -- assume that initial clause database is consistent 
-  assert (confl == CRef_Undef); // FS: Does anything break without this? Should disappear once we use assumption-based solving.
+  vec<CRef>& newProof = replay_proof;
+  CRef       confl    = CRef_Undef;
+  if (replay_pos < 0)
+    {
+      // -- an incremental validate() restored the database, move back over the whole proof
+      if (valid_lim > 0 || walk_pos >= 0)
+        {
+          lbool res = validateSteps (0, false, budgeted);
+          if (res == l_Undef) return l_Undef;
+          if (res == l_False) throw std::runtime_error("Validation failure.");
+        }
+      if (verbosity >= 2) printf ("REPLAYING: ");
+
+      // -- core flags have been changed by validate(), refresh the watcher tags
+      syncWatches ();
+
+      confl = propagate (true);
+      // -- assume that initial clause database is consistent
+      assert (confl == CRef_Undef); // FS: Does anything break without this? Should disappear once we use assumption-based solving.
 
-  labelLevel0(v);
+      labelLevel0(v);
+      replay_pos = 0;
+      newProof.clear ();
+      fixClear (false);
+    }
 
-  vec<CRef> newProof;
   bool bConflict = false;
-  for (int i = 0; i < proof.size(); ++i)
+  for (int i = replay_pos; i < proof.size(); ++i)
     {
       if (proof[i] == 0) break;
+      // -- stop between two steps, the trail is at level 0 here
+      if (budgeted && !withinBudget ())
+        {
+          replay_pos = i;
+          return l_Undef;
+        }
       if (verbosity >= 2) fflush (stdout);
 
-      CRef cr = proof [i];
+      CRef cr = proofStep (i);
       assert (cr != CRef_Undef);
       Clause &c = ca [cr];
 
@@ -446,9 +839,10 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
       // -- except for locked and core clauses
       if (c.mark() == 0)
       {
-    	  if (c.core() && c.learnt())
+    	  if (c.core())
     	  {
-    		  // If it is core, we do not delete it.
+    		  // If it is core, we do not delete it. An original clause is core here
+    		  // when it took the place of a lemma that it subsumes.
     		  continue;
     	  }
 
@@ -476,7 +870,10 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
 
     	  // If it is not core, it remains deleted, we do not care about it.
     	  if (!c.core())
+    	  {
+    		  pageOut(i);
     		  continue;
+    	  }
 
     	  // It cannot be locked?
     	  if (locked(c))
@@ -521,7 +918,7 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
       CRef p = propagate (true);
       if (p == CRef_Undef)
       {
-          printf ("BCP Failed at: %d out of: %d. Failure is: %d\n", i, proof.size(), cr);
+          printf ("BCP Failed at: %d out of: %d. Failure is: %" PRIu64 "\n", i, proof.size(), (uint64_t)cr);
     	  CRef p = propagate ();
     	  if (p != CRef_Undef) printf("GREAT SUCCESS!\n");
         throw std::runtime_error("BCP Failure.");
@@ -546,6 +943,7 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
       {
         learnt.clear();
         range.reset();
+        int pbase = step_pivots.size (), cbase = step_clauses.size ();
         bRes = traverse(v, cr, p, part, learnt, range);
 
         // XXX The handling of the case when bRes==false,
@@ -594,12 +992,12 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
 
 		      newProof.push(p);
 
-          if (learnt.size() > 1)
-            attachClause(p);
-
           ca[p].core(1);
           ca[p].mark(0);
 
+          if (learnt.size() > 1)
+            attachClause(p);
+
           // IS THIS ALWAYS TRUE?
           // I think that with reordering this is not necessarily true
           ca[cr].core(0);
@@ -608,13 +1006,13 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
           // update it
           if (cr == confl_assumps)
               confl_assumps = p;
-          v.visitChainResolvent(p);
+          visitChain(v, ProofStep::ChainClause, lit_Undef, p, pbase, cbase);
         }
         else {
             // In case the clauses are identical, we are done
             ca[cr].part(range);
             ca[cr].mark(0);
-            v.visitChainResolvent(cr);
+            visitChain(v, ProofStep::ChainClause, lit_Undef, cr, pbase, cbase);
             if (ca[cr].size() > 1) attachClause(cr);
             newProof.push(cr);
             break;
@@ -670,11 +1068,14 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
         // -- proof.
         ca[cr].mark(1);
         ca[cr].core (0);
+        // -- the simplifier deletes an original clause that is subsumed by a
+        // -- lemma, keep the clause that subsumes the lemma in its place
+        ca[p].core (1);
         cancelUntil (0);
 
         // FS
         if (cr == confl_assumps) {
-          CRef previous_cr = proof[i-1];
+          CRef previous_cr = proofStep(i-1);
           if (!ca[previous_cr].core () || !clausesAreEqual(confl_assumps, previous_cr)) {
             throw std::invalid_argument("Error handling duplicate clause during replay.");
           }
@@ -685,7 +1086,8 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
       }
     }
 
-  if (proof.size () == 1) labelFinal (v, proof [0]);
+  replay_pos = -1;
+  if (proof.size () == 1) labelFinal (v, proofStep (0));
   else if (conflict.size() > 0) {
       if (conflict.size() == 1) {
           //assert(value(ca[confl_assumps][0]) == l_False);
@@ -735,7 +1137,7 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
     for (int i=0; i < newProof.size(); i++)
         ca[newProof[i]].reloced(1);
     for (int i=0; i < proof.size()-1; i++) {
-        CRef cr = proof[i];
+        CRef cr = proofStep(i);
         Clause& c = ca[cr];
         if (c.reloced() == 0) {
             if (c.learnt()) {
@@ -745,7 +1147,7 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
         else
             assert(false);
       }
-      ca[proof[i]].core(0);
+      ca[cr].core(0);
     }
   // Clean mark
     for (int i=0; i < newProof.size(); i++)
@@ -762,40 +1164,62 @@ void Solver::replay (ProofVisitor& v, vec<CRef>* pOldProof)
     else
         proof.clear();
 
-    newProof.copyTo(proof);
+    newProof.moveTo(proof);
+    fixClear (true);
+    // -- the proof was rewritten, the next validation starts from scratch
+    valid_lim = 0;
+    valid_done.clear();
 
   // Clean the rest of the clauses
     for (int i=0; i < clauses.size(); i++) {
       ca[clauses[i]].core(0);
       assert(ca[clauses[i]].mark() == 0);
     }
+    learnts_core = 0;
     for (int i=0; i < learnts.size(); i++) {
       ca[learnts[i]].core(0);
       assert(ca[learnts[i]].mark() == 0);
+      if (ca[learnts[i]].tier() == Clause::tier_Core) learnts_core++;
     }
+  return l_True;
 }
 
 void Solver::labelFinal(ProofVisitor& v, CRef confl)
 {
     // The conflict clause is the clause with which we resolve.
     const Clause& source = ca[confl];
+    int pbase = step_pivots.size (), cbase = step_clauses.size ();
 
-    v.chainClauses.clear();
-    v.chainPivots.clear();
-
-    v.chainClauses.push(confl);
+    step_clauses.push(confl);
     // The clause is false, and results in the empty clause,
-    // all are therefore seen and resolved.
+    // all are therefore seen and resolved with units.
     for (int i = 0; i < source.size (); ++i)
-    {
-      v.chainPivots.push(~source [i]);
-      v.chainClauses.push(CRef_Undef);
-    }
-    v.visitChainResolvent(CRef_Undef);
+      step_pivots.push(~source [i]);
+    visitChain(v, ProofStep::ChainClause, lit_Undef, CRef_Undef, pbase, cbase);
+}
+
+// -- hands the chain at the end of 'step_pivots' and 'step_clauses',
+// -- starting at 'pbase' and 'cbase', to the visitor and drops it
+void Solver::visitChain(ProofVisitor& v, ProofStep::Kind kind, Lit lit, CRef cr, int pbase, int cbase)
+{
+    ProofStep s;
+    s.kind     = kind;
+    s.lit      = lit;
+    s.clause   = cr;
+    s.pivots   = (const Lit*)step_pivots + pbase;
+    s.nPivots  = step_pivots.size () - pbase;
+    s.clauses  = (const CRef*)step_clauses + cbase;
+    s.nClauses = step_clauses.size () - cbase;
+
+    v.visitSteps(&s, 1);
+
+    step_pivots.shrink_(s.nPivots);
+    step_clauses.shrink_(s.nClauses);
 }
 
-// XXX AG: would be cleaner if traverse returns chainClauses and
-// XXX chainPivots instead of taking a ProofVisitor object
+// -- on success, leaves the resolution chain at the end of 'step_pivots'
+// -- and 'step_clauses'. A chain built by a nested fixrec() is visited
+// -- and dropped before this one continues.
 bool Solver::traverse(ProofVisitor& v, CRef proofClause, 
                       CRef confl, int part, vec<Lit>& out_learnt, Range& range)
 {
@@ -813,8 +1237,8 @@ bool Solver::traverse(ProofVisitor& v, CRef proofClause,
   //
   int index   = trail.size() - 1;
 
-  vec<Lit> chainPivots;
-  vec<CRef> chainClauses;
+  int pbase = step_pivots.size ();
+  int cbase = step_clauses.size ();
 
   do{
     assert(confl != CRef_Undef); // (otherwise should be UIP)
@@ -830,8 +1254,8 @@ bool Solver::traverse(ProofVisitor& v, CRef proofClause,
 
     // the partition of the learned clause can be computed as the join
     // of partitions of all chainClauses and chainPivots.
-    chainClauses.push(confl);
-    if (p != lit_Undef && chainClauses.size() > 1) chainPivots.push (p);
+    step_clauses.push(confl);
+    if (p != lit_Undef && step_clauses.size() - cbase > 1) step_pivots.push (p);
 
     Clause& c = ca[confl];
 
@@ -871,13 +1295,12 @@ bool Solver::traverse(ProofVisitor& v, CRef proofClause,
 
   }while (pathC >= 0);
 
-  v.chainClauses.clear();
-  v.chainPivots.clear();
-
-  chainClauses.moveTo(v.chainClauses);
-  chainPivots.moveTo(v.chainPivots);
-
-  if (v.chainClauses.size () <= 1) return false;
+  if (step_clauses.size () - cbase <= 1)
+  {
+    step_pivots.shrink_(step_pivots.size () - pbase);
+    step_clauses.shrink_(step_clauses.size () - cbase);
+    return false;
+  }
   return true;
 
 }
@@ -885,11 +1308,24 @@ bool Solver::traverse(ProofVisitor& v, CRef proofClause,
 // XXX needs a better name than 'fixrec'
 CRef Solver::fixrec(ProofVisitor& v, CRef anchor, int part)
 {
+  PhaseTimer timer (stat, phase_Fixrec);
+
+  // -- reuse the resolvent created for this anchor before, if it is still
+  // -- a reason for the literal that 'anchor' implies
+  int e;
+  if (fix_cache.has (anchor, e) && fixValid (anchor, part, e))
+  {
+    CRef r = fix_entries[e].resolvent;
+    vardata[var(ca[r][0])].reason = r;
+    return r;
+  }
+
   // -- Need to check if traverse should be called or not.
 
   CRef resolvent = anchor;
   vec<Lit> learnt;
   Range range;
+  int pbase = step_pivots.size (), cbase = step_clauses.size ();
   bool bRes = traverse(v, CRef_Undef, anchor, part, learnt, range);
 
   if (bRes == false) return anchor;
@@ -914,6 +1350,7 @@ CRef Solver::fixrec(ProofVisitor& v, CRef anchor, int part)
       if (learnt.size() > 1) attachClause(resolvent);
 
       vardata[var(learnt[0])].reason = resolvent;
+      fixRecord (anchor, part, resolvent, pbase, cbase);
     }
     else
     {
@@ -932,15 +1369,73 @@ CRef Solver::fixrec(ProofVisitor& v, CRef anchor, int part)
     c.core(1);
     c.mark(0);
     c.part(range);
+    syncWatches(resolvent);
 
-    v.visitChainResolvent(resolvent);
+    visitChain(v, ProofStep::ChainClause, lit_Undef, resolvent, pbase, cbase);
+  }
+  else
+  {
+    // -- nothing new was derived, drop the chain
+    step_pivots.shrink_(step_pivots.size () - pbase);
+    step_clauses.shrink_(step_clauses.size () - cbase);
   }
 
 	return resolvent;
 }
 
+// -- the resolvent of entry 'e' can stand in for 'anchor' if the literal
+// -- that 'anchor' implies is still its first one, and the pivots of its
+// -- chain are still implied by the same reasons. Its other literals are
+// -- then false, as they come from 'anchor' and from those reasons. Its
+// -- second watch must still be on the literal of the highest level.
+bool Solver::fixValid(CRef anchor, int part, int e) const
+{
+    const FixEntry& f = fix_entries[e];
+    if (f.part != part) return false;
+
+    const Clause& r = ca[f.resolvent];
+    if (r.mark () != 0 || r[0] != ca[anchor][0] || value (r[0]) != l_True) return false;
+    for (int i = 2; i < r.size (); i++)
+        if (level (var (r[i])) > level (var (r[1]))) return false;
+
+    for (int i = f.start; i < f.start + f.size; i++)
+        if (value (fix_pivots[i]) != l_True || reason (var (fix_pivots[i])) != fix_reasons[i])
+            return false;
+    return true;
+}
+
+// -- records the chain at the end of 'step_pivots' and 'step_clauses',
+// -- starting at 'pbase' and 'cbase', that derived 'resolvent' from 'anchor'
+void Solver::fixRecord(CRef anchor, int part, CRef resolvent, int pbase, int cbase)
+{
+    FixEntry f;
+    f.resolvent = resolvent;
+    f.part      = part;
+    f.start     = fix_pivots.size ();
+    f.size      = step_pivots.size () - pbase;
+    // -- pivot i was resolved with clause i+1 of the chain, its reason
+    for (int i = 0; i < f.size; i++){
+        fix_pivots .push (step_pivots [pbase + i]);
+        fix_reasons.push (step_clauses[cbase + i + 1]); }
+
+    fix_cache.insert (anchor, fix_entries.size ());
+    fix_entries.push (f);
+}
+
+void Solver::fixClear(bool dealloc)
+{
+    fix_cache  .clear (dealloc);
+    fix_entries.clear (dealloc);
+    fix_pivots .clear (dealloc);
+    fix_reasons.clear (dealloc);
+}
+
 void Solver::labelLevel0(ProofVisitor& v)
 {
+  PhaseTimer timer (stat, phase_Level0);
+  int pbase = step_pivots.size (), cbase = step_clauses.size ();
+  step_buf.clear ();
+
     // -- Walk the trail forward
   while (start < trail.size ())
   {
@@ -963,25 +1458,44 @@ void Solver::labelLevel0(ProofVisitor& v)
     {
       r.join (trail_part [var(c[1])]);
       trail_part [x] = r;
-      v.visitResolvent(q, ~c[1], reason(x)); // -- Binary resolution
+      // -- Binary resolution
+      ProofStep s = { ProofStep::Resolvent, q, CRef_Undef, NULL, 1, NULL, 1 };
+      step_buf.push (s);
+      step_pivots.push (~c[1]);
+      step_clauses.push (reason(x));
     }
     else
     {
-      v.chainClauses.clear ();
-      v.chainPivots.clear ();
-
-      v.chainClauses.push (reason(x));
+      // -- The other antecedents are units, they are not stored.
+      ProofStep s = { ProofStep::ChainLit, q, CRef_Undef, NULL, c.size () - 1, NULL, 1 };
+      step_buf.push (s);
+      step_clauses.push (reason(x));
       // -- The first literal (0) is the result of resolution, start from 1.
       for (int j = 1; j < c.size (); j++)
       {
         r.join (trail_part[var(c[j])]);
-        v.chainPivots.push (~c[j]);
-        v.chainClauses.push(CRef_Undef);
+        step_pivots.push (~c[j]);
       }
       trail_part [x] = r;
-      v.visitChainResolvent (q);
     }
   }
+
+  if (step_buf.size () == 0) return;
+
+  // -- The spans are set once the buffers do not grow anymore, and the
+  // -- whole pass is handed to the visitor at once.
+  const Lit*  ps = (const Lit*)step_pivots + pbase;
+  const CRef* cs = (const CRef*)step_clauses + cbase;
+  for (int i = 0; i < step_buf.size (); i++)
+  {
+    step_buf [i].pivots  = ps; ps += step_buf [i].nPivots;
+    step_buf [i].clauses = cs; cs += step_buf [i].nClauses;
+  }
+  v.visitSteps (step_buf, step_buf.size ());
+
+  step_pivots.shrink_(step_pivots.size () - pbase);
+  step_clauses.shrink_(step_clauses.size () - cbase);
+  step_buf.clear ();
 }
 
 //=================================================================================================
@@ -996,14 +1510,19 @@ Var Solver::newVar(bool sign, bool dvar)
     int v = nVars();
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
+    watch_unsorted.push(0);
+    watch_unsorted.push(0);
     assigns  .push(l_Undef);
     vardata  .push(mkVarData(CRef_Undef, 0));
     //activity .push(0);
     activity .push(rnd_init_act ? drand(random_seed) * 0.00001 : 0);
     seen     .push(0);
+    lbd_levels.growTo(v + 2, 0);
     polarity .push(sign);
     decision .push();
     trail    .capacity(v+1);
+    vmtf_links.push();
+    vmtfEnqueue(v);
     setDecisionVar(v, dvar);
 
     partInfo.push(Range ());
@@ -1015,7 +1534,8 @@ Var Solver::newVar(bool sign, bool dvar)
 
 bool Solver::addClause_(vec<Lit>& ps, Range part)
 {
-    assert(decisionLevel() == 0);
+    // -- a new clause may propagate under the kept assumptions, drop them
+    cancelUntil(0);
     assert (!log_proof || !part.undef ());
 
     if (!ok) return false;
@@ -1081,7 +1601,7 @@ bool Solver::addClause_(vec<Lit>& ps, Range part)
           clauses.push (cr);
           totalPart.join (part);
           uncheckedEnqueue (ps[0], cr);
-          if (ps.size() > 1) attachClause(cr);
+          if (ps.size() > 1 && bulk_clauses < 0) attachClause(cr);
         }
       else
         uncheckedEnqueue(ps[0]);
@@ -1090,6 +1610,7 @@ bool Solver::addClause_(vec<Lit>& ps, Range part)
       /* for (int i = 0; part.singleton () && i < ps.size (); ++i)
         partInfo [var (ps[i])].join (part); */
 
+      if (bulk_clauses >= 0) return true;
       CRef confl = propagate ();
       if (log_proof && confl != CRef_Undef) proof.push (confl);
       return ok = (confl == CRef_Undef);
@@ -1099,7 +1620,7 @@ bool Solver::addClause_(vec<Lit>& ps, Range part)
         c.part ().join (part);
         clauses.push(cr);
         totalPart.join (part);
-        attachClause(cr);
+        if (bulk_clauses < 0) attachClause(cr);
 
         /* for (i = 0; part.singleton () && i < ps.size(); i++)
            partInfo[var (ps[i])].join (part); */
@@ -1110,22 +1631,87 @@ bool Solver::addClause_(vec<Lit>& ps, Range part)
 }
 
 
-void Solver::attachClause(CRef cr) {
-    const Clause& c = ca[cr];
-    assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
-    if (c.learnt()) learnts_literals += c.size();
-    else            clauses_literals += c.size(); }
+void Solver::beginClauses(int n, uint64_t lits)
+{
+    cancelUntil(0);
+    assert(bulk_clauses < 0);
+    reserveClauses(n, lits);
+    bulk_clauses = clauses.size();
+    bulk_trail   = qhead;
+}
 
 
-void Solver::detachClause(CRef cr, bool strict) {
-    const Clause& c = ca[cr];
+bool Solver::commitClauses()
+{
+    assert(bulk_clauses >= 0);
+
+    // -- size every watch list once, then attach the new clauses in the order they were added
+    vec<int> n(2 * nVars(), 0);
+    for (int i = bulk_clauses; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.size() > 1) n[toInt(~c[0])]++, n[toInt(~c[1])]++; }
+    for (int i = 0; i < n.size(); i++)
+        if (n[i] > 0) watches[toLit(i)].capacity(watches[toLit(i)].size() + n[i]);
+    for (int i = bulk_clauses; i < clauses.size(); i++)
+        if (ca[clauses[i]].size() > 1) attachClause(clauses[i]);
+    bulk_clauses = -1;
+
+    if (!ok) return false;
+
+    // -- 'SimpSolver::implied()' may have propagated some of the new units before their watchers
+    // -- were attached, so all of them are propagated again
+    if (qhead > bulk_trail) qhead = bulk_trail;
+    CRef confl = propagate ();
+    if (log_proof && confl != CRef_Undef) proof.push (confl);
+    return ok = (confl == CRef_Undef);
+}
+
+
+void Solver::attachClause(CRef cr) {
+    const Clause& c = ca[cr];
+    assert(c.size() > 1);
+    attachWatch(~c[0], Watcher(cr, c[1], c));
+    attachWatch(~c[1], Watcher(cr, c[0], c));
+    if (c.learnt()) learnts_literals += c.size();
+    else            clauses_literals += c.size(); }
+
+
+void Solver::joinPart(CRef cr, const Range& r) {
+    ca[cr].part().join(r);
+    syncWatches(cr); }
+
+
+void Solver::syncWatches(CRef cr) {
+    const Clause& c = ca[cr];
+    if (c.size() < 2) return;
+    for (int k = 0; k < 2; k++){
+        WatchList ws = watches[~c[k]];
+        for (int i = 0; i < ws.size(); i++)
+            if (ws[i].cref == cr) syncWatch(~c[k], ws[i], c);
+    }
+}
+
+
+void Solver::syncWatches() {
+    watches.cleanAll();
+    for (int v = 0; v < nVars(); v++)
+        for (int s = 0; s < 2; s++){
+            Lit p = mkLit(v, s);
+            WatchList ws = watches[p];
+            for (int i = 0; i < ws.size(); i++)
+                syncWatch(p, ws[i], ca[ws[i].cref]);
+        }
+}
+
+
+void Solver::detachClause(CRef cr, bool strict) {
+    const Clause& c = ca[cr];
     assert(c.size() > 1);
 
     if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        WatchList ws0 = watches[~c[0]], ws1 = watches[~c[1]];
+        remove(ws0, Watcher(cr, c[1], c));
+        remove(ws1, Watcher(cr, c[0], c));
     }else{
         // Lazy detaching: (NOTE! Must clean all watcher lists before garbage collecting this clause)
         watches.smudge(~c[0]);
@@ -1139,11 +1725,13 @@ void Solver::detachClause(CRef cr, bool strict) {
 void Solver::removeClause(CRef cr) {
     if (log_proof) proof.push (cr);
     Clause& c = ca[cr];
+    if (c.learnt() && c.tier() == Clause::tier_Core) learnts_core--;
     if (c.size () > 1) detachClause(cr);
     // Don't leave pointers to free'd memory!
     if (locked(c) && !log_proof) vardata[var(c[0])].reason = CRef_Undef;
     c.mark(1);
-    if (!log_proof) ca.free(cr);
+    // -- with proof spilling, the memory of the clause is reclaimed by 'relocAll()'
+    if (!log_proof || proof_spill) ca.free(cr);
 }
 
 
@@ -1170,6 +1758,18 @@ void Solver::cancelUntil(int level) {
     } }
 
 
+// The assumptions are decided again in the same order after a restart, and propagated to the same
+// literals, so their levels are kept. Only the simplification of the clause database and the
+// import of clauses need level 0.
+int Solver::restartLevel() const
+{
+    int level0 = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+    if (!reuse_trail || exchange != NULL || (simpDB_props <= 0 && level0 != simpDB_assigns))
+        return 0;
+    return std::min(decisionLevel(), assumptions.size());
+}
+
+
 //=================================================================================================
 // Major methods:
 
@@ -1179,13 +1779,21 @@ Lit Solver::pickBranchLit()
     Var next = var_Undef;
 
     // Random decision:
-    if (drand(random_seed) < random_var_freq && !order_heap.empty()){
-        next = order_heap[irand(random_seed,order_heap.size())];
+    if (drand(random_seed) < random_var_freq && (vmtf ? nVars() > 0 : !order_heap.empty())){
+        next = vmtf ? irand(random_seed,nVars()) : order_heap[irand(random_seed,order_heap.size())];
         if (value(next) == l_Undef && decision[next])
-            rnd_decisions++; }
+            rnd_decisions++;
+        else
+            next = var_Undef; }
+
+    // Recency based decision, the search position only moves back until a variable is unassigned:
+    if (vmtf && next == var_Undef){
+        while (vmtf_search != var_Undef && (value(vmtf_search) != l_Undef || !decision[vmtf_search]))
+            vmtf_search = vmtf_links[vmtf_search].prev;
+        next = vmtf_search; }
 
     // Activity based decision:
-    while (next == var_Undef || value(next) != l_Undef || !decision[next])
+    while (!vmtf && (next == var_Undef || value(next) != l_Undef || !decision[next]))
         if (order_heap.empty()){
             next = var_Undef;
             break;
@@ -1196,6 +1804,67 @@ Lit Solver::pickBranchLit()
 }
 
 
+// Scale the activity bumps of each variable by 'part_bias' to the power of the highest partition of
+// the original clauses it occurs in, less one. Variables of lower partitions then come first in
+// the decision order, which keeps the learnt clauses within fewer partitions, so that 'replay()'
+// has less to reorder.
+void Solver::partBumpScale()
+{
+    vec<double> scale(totalPart.max() + 1, 1);
+    for (unsigned p = 2; p < (unsigned)scale.size(); p++)
+        scale[p] = scale[p-1] * part_bias;
+
+    vec<unsigned> top(nVars(), 1);
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (c.part().undef()) continue;
+        for (int j = 0; j < c.size(); j++)
+            if (top[var(c[j])] < c.part().max()) top[var(c[j])] = c.part().max(); }
+
+    bump_scale.clear();
+    for (Var v = 0; v < nVars(); v++)
+        bump_scale.push(scale[top[v]]);
+}
+
+
+// The most active variable, or the most recently bumped one with VMTF, that is not in 'cube' and
+// not fixed at the root level. Var_Undef if there is none.
+Var Solver::splitVar(const vec<Lit>& cube)
+{
+    for (int i = 0; i < cube.size(); i++) seen[var(cube[i])] = 1;
+
+    Var next = var_Undef;
+    if (vmtf){
+        for (Var v = vmtf_last; v != var_Undef && next == var_Undef; v = vmtf_links[v].prev)
+            if (decision[v] && !seen[v] && (value(v) == l_Undef || level(v) > 0))
+                next = v;
+    }else
+        for (Var v = 0; v < nVars(); v++)
+            if (decision[v] && !seen[v] && (value(v) == l_Undef || level(v) > 0) && (next == var_Undef || activity[v] > activity[next]))
+                next = v;
+
+    for (int i = 0; i < cube.size(); i++) seen[var(cube[i])] = 0;
+    return next;
+}
+
+
+void Solver::vmtfBump()
+{
+    // -- moving the variables in the order of their old stamps keeps their relative order
+    sort(vmtf_bumped, VmtfStampLt(vmtf_links));
+    for (int i = 0; i < vmtf_bumped.size(); i++){
+        Var v = vmtf_bumped[i];
+        if (v != vmtf_last){
+            vmtfDequeue(v);
+            vmtfEnqueue(v); }
+        else
+            vmtf_links[v].stamp = ++vmtf_stamp;
+        if (value(v) == l_Undef) vmtf_search = v;
+    }
+    vmtf_bumped.clear();
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  analyze : (confl : Clause*) (out_learnt : vec<Lit>&) (out_btlevel : int&)  ->  [void]
@@ -1232,8 +1901,12 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel,
 
         if (log_proof) part.join (c.part ());
 
-        if (c.learnt())
+        if (c.learnt()){
             claBumpActivity(c);
+            if (c.tier() != Clause::tier_Core){
+                unsigned lbd = computeLBD(c);
+                if (lbd < c.lbd()) claSetLBD(c, lbd);
+                c.used(true); } }
 
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
@@ -1241,7 +1914,9 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel,
             if (!seen[var(q)]){
               if (level(var(q)) > 0)
                 {
-                  varBumpActivity(var(q));
+                  if (vmtf) vmtf_bumped.push(var(q));
+                  else if (bump_scale.size() > 0) varBumpActivity(var(q), var_inc * bump_scale[var(q)]);
+                  else      varBumpActivity(var(q));
                   seen[var(q)] = 1;
                   if (level(var(q)) >= decisionLevel())
                     pathC++;
@@ -1266,6 +1941,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel,
 
     }while (pathC > 0);
     out_learnt[0] = ~p;
+    if (vmtf) vmtfBump();
 
     // Simplify conflict clause:
     //
@@ -1414,12 +2090,45 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict, Range& part)
 }
 
 
+// Like 'analyzeFinal()', but starts from a conflict and only collects the partitions of the clauses
+// involved (including those of the level 0 literals):
+Range Solver::conflictPart(CRef confl)
+{
+    Range    part = ca[confl].part();
+    Clause&  cc   = ca[confl];
+    for (int i = 0; i < cc.size(); i++)
+        if (level(var(cc[i])) > 0)
+            seen[var(cc[i])] = 1;
+        else
+            part.join(trail_part[var(cc[i])]);
+
+    for (int i = trail.size()-1; i >= trail_lim[0]; i--){
+        Var x = var(trail[i]);
+        if (seen[x]){
+            if (reason(x) != CRef_Undef){
+                Clause& c = ca[reason(x)];
+                part.join(c.part());
+                for (int j = 1; j < c.size(); j++)
+                    if (level(var(c[j])) > 0)
+                        seen[var(c[j])] = 1;
+                    else
+                        part.join(trail_part[var(c[j])]);
+            }
+            seen[x] = 0;
+        }
+    }
+
+    return part;
+}
+
+
 void Solver::uncheckedEnqueue(Lit p, CRef from)
 {
     assert(value(p) == l_Undef);
     assigns[var(p)] = lbool(!sign(p));
     vardata[var(p)] = mkVarData(from, decisionLevel());
     trail.push_(p);
+    if (stats_enabled && from != CRef_Undef) stat.implied(ca[from].part().max());
 
     // -- everything at level 0 has a reason
     assert (!log_proof || decisionLevel () != 0 || from != CRef_Undef);
@@ -1441,65 +2150,70 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 
 /*_________________________________________________________________________________________________
 |
-|  propagate : [void]  ->  [Clause*]
+|  propagate_ : (maxPart : int)  ->  [Clause*]
 |
 |  Description:
 |    Propagates all enqueued facts. If a conflict arises, the conflicting clause is returned,
-|    otherwise CRef_Undef.
+|    otherwise CRef_Undef. With 'CoreOnly', only core clauses are used; with 'Bounded', only
+|    clauses whose partition does not exceed 'maxPart'. The mode is a template parameter so
+|    that plain search runs a loop without any filtering.
 |
 |    Post-conditions:
 |      * the propagation queue is empty, even if there was a conflict.
 |________________________________________________________________________________________________@*/
-CRef Solver::propagate(bool coreOnly, int maxPart)
+template<bool CoreOnly, bool Bounded>
+CRef Solver::propagate_(int maxPart)
 {
-
     CRef    confl     = CRef_Undef;
-
-    // -- in ordered propagate mode, keep applying propagate with increasing partitions
-    if (ordered_propagate && maxPart == 0)
-    {
-      int init_qhead = qhead;
-      for (int i = 1; confl == CRef_Undef && i <= totalPart.max (); i++)
-      {
-        // -- reset qhead to the beginning
-        qhead = init_qhead;
-        // -- propagate up to (and including) partition i
-        confl = propagate (coreOnly, i);
-      }
-      return confl;
-    }
-
     int     num_props = 0;
     watches.cleanAll();
+    // -- watchers are appended below, partition order of watch lists is lost
+    watches_ordered = false;
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
-        vec<Watcher>&  ws  = watches[p];
-        Watcher        *i, *j, *end;
+        WatchList      ws  = watches[p];
+        Watcher        *i, *j, *end, *base;
         num_props++;
 
-        //sort (ws, WatcherLt(ca));
-        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+        for (i = j = base = ws, end = i + ws.size();  i != end;){
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
             if (value(blocker) == l_True){
                 *j++ = *i++; continue; }
 
+            // Filter on the watcher tags before inspecting the clause:
+            if (CoreOnly && !i->core) { *j++ = *i++; continue; }
+            if (Bounded && (unsigned)maxPart < i->part) { *j++ = *i++; continue; }
+
+            // Binary clauses are propagated from the watcher alone:
+            if (i->binary){
+                CRef cr = i->cref;
+                *j++ = *i++;
+                if (value(blocker) == l_False){
+                    confl = cr;
+                    normalizeBinary(blocker, cr);
+                    qhead = trail.size();
+                    // Copy the remaining watches:
+                    while (i < end)
+                        *j++ = *i++;
+                }else
+                    uncheckedEnqueueBinary(blocker, cr);
+                continue; }
+
             CRef     cr        = i->cref;
             Clause&  c         = ca[cr];
-
-            if (coreOnly && !c.core ()) { *j++ = *i++; continue; }
-            if (maxPart > 0 && maxPart < c.part ().max ()) { *j++ = *i++; continue; }
+            assert(!CoreOnly || c.core ());
 
             // Make sure the false literal is data[1]:
             Lit      false_lit = ~p;
             if (c[0] == false_lit)
                 c[0] = c[1], c[1] = false_lit;
             assert(c[1] == false_lit);
-            i++;
 
             // If 0th watch is true, then clause is already satisfied.
             Lit     first = c[0];
-            Watcher w     = Watcher(cr, first);
+            Watcher w     = *i++;
+            w.blocker     = first;
             if (first != blocker && value(first) == l_True){
                 *j++ = w; continue; }
 
@@ -1508,6 +2222,7 @@ CRef Solver::propagate(bool coreOnly, int maxPart)
                 if (value(c[k]) != l_False){
                     c[1] = c[k]; c[k] = false_lit;
                     watches[~c[1]].push(w);
+                    if (base != (Watcher*)ws) rebase(base, (Watcher*)ws, i, j, end);
                     goto NextClause; }
 
             // Did not find watch -- clause is unit under assignment:
@@ -1532,31 +2247,241 @@ CRef Solver::propagate(bool coreOnly, int maxPart)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateOrdered : [void]  ->  [Clause*]
+|
+|  Description:
+|    Propagates all enqueued facts such that clauses of partition 'k' are only used once the
+|    clauses of partitions 1..k-1 have been propagated to a fixpoint. Watch lists are sorted by
+|    partition before they are used, and every propagated literal is queued for the partition of
+|    its next pending watcher. Every watcher of a propagated literal is thus inspected once,
+|    rather than once per partition. Clauses without a partition are treated as belonging to
+|    partition 1, clauses above 'totalPart' are ignored.
+|
+|    Post-conditions:
+|      * the propagation queue is empty, even if there was a conflict.
+|________________________________________________________________________________________________@*/
+template<bool CoreOnly>
+CRef Solver::propagateOrdered()
+{
+    CRef    confl     = CRef_Undef;
+    int     num_props = 0;
+    int     nparts    = totalPart.max();
+    int     head      = qhead;
+    watches.cleanAll();
+    if (!watches_ordered) orderWatches();
+
+    part_queue.growTo(nparts + 1);
+    part_qhead.growTo(nparts + 1, 0);
+    part_rpos .growTo(nVars());
+    part_wpos .growTo(nVars());
+
+    for (int k = 1;;){
+        // -- queue the new implications for the partition of their first watcher
+        for (; head < trail.size(); head++){
+            Lit p = trail[head];
+            num_props++;
+            part_rpos[var(p)] = part_wpos[var(p)] = 0;
+            if (watch_unsorted[toInt(p)] > 0) orderWatches(p);
+            WatchList ws = watches[p];
+            if (ws.size() > 0 && ws[0].part <= (unsigned)nparts){
+                int q = ws[0].part == Range::part_Undef ? 1 : ws[0].part;
+                part_queue[q].push(p);
+                if (q < k) k = q; }
+        }
+
+        while (k <= nparts && part_qhead[k] == part_queue[k].size()){
+            part_queue[k].clear(); part_qhead[k] = 0; k++; }
+        if (k > nparts) break;
+
+        Lit            p   = part_queue[k][part_qhead[k]++];
+        WatchList      ws  = watches[p];
+        Watcher        *i, *j, *end, *base = ws;
+
+        // -- no watcher is added to 'ws' while 'p' is true, so the segment of partition 'k'
+        // -- starts where the previously propagated one ended; the gap left by watchers that
+        // -- moved to other lists is carried along and closed once propagation is done
+        int seg = part_rpos[var(p)];
+        while (seg < ws.size() && ws[seg].part <= (unsigned)k) seg++;
+
+        // -- propagate the watchers of partition 'k' only
+        for (i = base + part_rpos[var(p)], j = base + part_wpos[var(p)], end = base + seg;  i != end;){
+            Lit blocker = i->blocker;
+            if (value(blocker) == l_True){
+                *j++ = *i++; continue; }
+
+            if (CoreOnly && !i->core) { *j++ = *i++; continue; }
+
+            if (i->binary){
+                CRef cr = i->cref;
+                *j++ = *i++;
+                if (value(blocker) == l_False){
+                    confl = cr;
+                    normalizeBinary(blocker, cr);
+                    while (i < end)
+                        *j++ = *i++;
+                }else
+                    uncheckedEnqueueBinary(blocker, cr);
+                continue; }
+
+            CRef     cr        = i->cref;
+            Clause&  c         = ca[cr];
+            assert(!CoreOnly || c.core ());
+
+            Lit      false_lit = ~p;
+            if (c[0] == false_lit)
+                c[0] = c[1], c[1] = false_lit;
+            assert(c[1] == false_lit);
+
+            Lit     first = c[0];
+            Watcher w     = *i++;
+            w.blocker     = first;
+            if (first != blocker && value(first) == l_True){
+                *j++ = w; continue; }
+
+            for (int l = 2; l < c.size(); l++)
+                if (value(c[l]) != l_False){
+                    c[1] = c[l]; c[l] = false_lit;
+                    watches[~c[1]].push(w);
+                    watch_unsorted[toInt(~c[1])]++;
+                    if (base != (Watcher*)ws) rebase(base, (Watcher*)ws, i, j, end);
+                    goto NextClause; }
+
+            *j++ = w;
+            if (value(first) == l_False){
+                confl = cr;
+                while (i < end)
+                    *j++ = *i++;
+            }else
+                uncheckedEnqueue(first, cr);
+
+        NextClause:;
+        }
+        part_rpos[var(p)] = seg;
+        part_wpos[var(p)] = j - base;
+
+        if (confl != CRef_Undef) break;
+        // -- queue 'p' again for the partition of its next pending watcher
+        if (seg < ws.size() && ws[seg].part <= (unsigned)nparts)
+            part_queue[ws[seg].part].push(p);
+    }
+
+    // -- close the gaps in the watch lists of all literals that have been propagated
+    for (int t = qhead; t < head; t++){
+        Var v = var(trail[t]);
+        if (part_rpos[v] == part_wpos[v]) continue;
+        WatchList ws = watches[trail[t]];
+        int i, j;
+        for (i = part_rpos[v], j = part_wpos[v]; i < ws.size(); i++, j++)
+            ws[j] = ws[i];
+        ws.shrink(i - j);
+    }
+    for (int k = 1; k <= nparts; k++){
+        part_queue[k].clear(); part_qhead[k] = 0; }
+
+    num_props += trail.size() - head;
+    qhead = trail.size();
+    propagations += num_props;
+    simpDB_props -= num_props;
+
+    return confl;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  propagate : (coreOnly : bool) (maxPart : int)  ->  [Clause*]
+|
+|  Description:
+|    Propagates all enqueued facts. If a conflict arises, the conflicting clause is returned,
+|    otherwise CRef_Undef. Only core clauses are used if 'coreOnly' is set, and only clauses up
+|    to partition 'maxPart' if it is positive. In ordered propagate mode (and 'maxPart == 0'),
+|    lower partitions are propagated to a fixpoint first.
+|
+|    Post-conditions:
+|      * the propagation queue is empty, even if there was a conflict.
+|________________________________________________________________________________________________@*/
+CRef Solver::propagate(bool coreOnly, int maxPart)
+{
+    if (ordered_propagate && maxPart == 0)
+        return coreOnly ? propagateOrdered<true>() : propagateOrdered<false>();
+    if (maxPart > 0)
+        return coreOnly ? propagate_<true, true>(maxPart) : propagate_<false, true>(maxPart);
+    return coreOnly ? propagate_<true, false>(0) : propagate_<false, false>(0);
+}
+
+
+void Solver::orderWatches()
+{
+    for (int v = 0; v < nVars(); v++)
+        for (int s = 0; s < 2; s++){
+            Lit p = mkLit(v, s);
+            WatchList ws = watches[p];
+            sort((Watcher*)ws, ws.size(), WatcherPartLt());
+            watch_unsorted[toInt(p)] = 0; }
+    watches_ordered = true;
+}
+
+
+void Solver::orderWatches(Lit p)
+{
+    // -- only the watchers appended since the list was last sorted can be out of order
+    // -- (lazy cleaning preserves the order, but may leave the bound too large): sort them
+    // -- separately and merge them into the sorted prefix from the back
+    WatchList     ws  = watches[p];
+    int           beg = ws.size() - watch_unsorted[toInt(p)];
+    if (beg < 0) beg = 0;
+    watch_tmp.clear();
+    for (int i = beg; i < ws.size(); i++) watch_tmp.push(ws[i]);
+    sort(watch_tmp, WatcherPartLt());
+    for (int i = beg - 1, t = watch_tmp.size() - 1, k = ws.size() - 1; t >= 0; k--)
+        if (i >= 0 && watch_tmp[t].part < ws[i].part)
+            ws[k] = ws[i--];
+        else
+            ws[k] = watch_tmp[t--];
+    watch_unsorted[toInt(p)] = 0;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  reduceDB : ()  ->  [void]
 |
 |  Description:
-|    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
-|    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|    The learnt clauses are kept in three tiers by their LBD. Core clauses (LBD at most 'core_lbd')
+|    are never removed. Tier-two clauses (LBD at most 'tier2_lbd') stay as long as they take part in
+|    a conflict between two reductions, otherwise they drop to the local tier. Of the local clauses,
+|    remove half, minus the clauses locked by the current assignment. Locked clauses are clauses
+|    that are reason to some assignment. Binary clauses are never removed.
 |________________________________________________________________________________________________@*/
 struct reduceDB_lt {
     ClauseAllocator& ca;
     reduceDB_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool local(const Clause& c) { return c.size() > 2 && c.tier() == Clause::tier_Local; }
     bool operator () (CRef x, CRef y) {
-        return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); }
+        return local(ca[x]) && (!local(ca[y]) || ca[x].activity() < ca[y].activity()); }
 };
 void Solver::reduceDB()
 {
     int     i, j;
-    double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
+    int     nlocal = 0;
+    learnts_core = 0;
+    for (i = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.tier() == Clause::tier_Two && !c.used()) c.tier(Clause::tier_Local);
+        if (c.tier() == Clause::tier_Core) learnts_core++;
+        if (c.tier() == Clause::tier_Local && c.size() > 2) nlocal++;
+        c.used(false);
+    }
+    double  extra_lim = cla_inc / nlocal;            // Remove any clause below this activity
 
     sort(learnts, reduceDB_lt(ca));
-    // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
-    // and clauses with activity smaller than 'extra_lim':
+    // The local clauses come first. Don't delete binary or locked clauses. From the rest, delete
+    // clauses from the first half and clauses with activity smaller than 'extra_lim':
     for (i = j = 0; i < learnts.size(); i++){
         Clause& c = ca[learnts[i]];
-        if (c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
+        if (i < nlocal && !locked(c) && (i < nlocal / 2 || c.activity() < extra_lim))
             removeClause(learnts[i]);
         else
             learnts[j++] = learnts[i];
@@ -1587,6 +2512,7 @@ void Solver::rebuildOrderHeap()
         if (decision[v] && value(v) == l_Undef)
             vs.push(v);
     order_heap.build(vs);
+    vmtf_search = vmtf_last;
 }
 
 
@@ -1600,7 +2526,9 @@ void Solver::rebuildOrderHeap()
 |________________________________________________________________________________________________@*/
 bool Solver::simplify()
 {
-    assert(decisionLevel() == 0);
+    PhaseTimer timer(stat, phase_Simplify);
+    cancelUntil(0);
+    assert(bulk_clauses < 0);
 
     if (!ok) return false;
 
@@ -1679,6 +2607,7 @@ lbool Solver::search(int nof_conflicts)
         if (confl != CRef_Undef){
 
             conflicts++; conflictC++;
+            if (stats_enabled) stat.conflict(ca[confl].part().max());
             if (decisionLevel() == 0)
               {
                 if (log_proof) proof.push (confl);
@@ -1687,6 +2616,7 @@ lbool Solver::search(int nof_conflicts)
 
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level, part);
+            unsigned lbd = computeLBD(learnt_clause);
             cancelUntil(backtrack_level);
 
             if (learnt_clause.size() == 1){
@@ -1707,9 +2637,13 @@ lbool Solver::search(int nof_conflicts)
                 learnts.push(cr);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
+                claSetLBD(ca[cr], lbd);
                 uncheckedEnqueue(learnt_clause[0], cr);
             }
 
+            if (exchange != NULL && learnt_clause.size() <= share_lim)
+                exchange->push(exchange_id, learnt_clause, part);
+
             varDecayActivity();
             claDecayActivity();
 
@@ -1730,14 +2664,14 @@ lbool Solver::search(int nof_conflicts)
             if (nof_conflicts >= 0 && conflictC >= nof_conflicts || !withinBudget()){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                cancelUntil(restartLevel());
                 return l_Undef; }
 
             // Simplify the set of problem clauses:
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
 
-            if (learnts.size()-nAssigns() >= max_learnts)
+            if (learnts.size()-learnts_core-nAssigns() >= max_learnts)
                 // Reduce the set of learnt clauses:
                 reduceDB();
 
@@ -1782,6 +2716,72 @@ lbool Solver::search(int nof_conflicts)
     }
 }
 
+/*_________________________________________________________________________________________________
+|
+|  importClauses : [void]  ->  [bool]
+|
+|  Description:
+|    Adds the clauses the other solvers of a portfolio exported since the last restart, as learnt
+|    clauses. With proof logging, a clause is only added if unit propagation derives it here as
+|    well, so that it is a lemma of this solver's proof. Its partition is then the one of the
+|    clauses the propagation used, not the one it had in the solver that exported it.
+|________________________________________________________________________________________________@*/
+bool Solver::importClauses()
+{
+    assert(decisionLevel() == 0);
+    vec<Lit>& c = import_tmp;
+    Range     part;
+
+    while (exchange->pull(exchange_id, c, part)){
+        // -- drop satisfied clauses and false literals, as 'addClause_()' does
+        int  i, j;
+        bool sat = false;
+        for (i = j = 0; i < c.size() && !sat; i++)
+            if      (value(c[i]) == l_True)  sat = true;
+            else if (value(c[i]) == l_Undef) c[j++] = c[i];
+        if (sat) continue;
+        c.shrink(i - j);
+
+        if (log_proof){
+            if (c.size() == 0) continue;
+            newDecisionLevel();
+            for (int k = 0; k < c.size(); k++)
+                if (value(c[k]) == l_Undef) uncheckedEnqueue(~c[k]);
+            CRef confl = propagate();
+            if (confl != CRef_Undef) part = conflictPart(confl);
+            cancelUntil(0);
+            if (confl == CRef_Undef) continue;
+        }
+
+        if (c.size() == 0)
+            return ok = false;
+        else if (c.size() == 1){
+            CRef cr = CRef_Undef;
+            if (log_proof){
+                cr = ca.alloc(c, true);
+                ca[cr].part(part);
+                proof.push(cr); }
+            uncheckedEnqueue(c[0], cr);
+
+            CRef confl = propagate();
+            if (confl != CRef_Undef){
+                if (log_proof) proof.push(confl);
+                return ok = false; }
+        }else{
+            CRef cr = ca.alloc(c, true);
+            ca[cr].part(part);
+            if (log_proof) proof.push(cr);
+            learnts.push(cr);
+            attachClause(cr);
+            claBumpActivity(ca[cr]);
+            claSetLBD(ca[cr], c.size()); // (the size bounds the LBD, which is not known at level 0)
+        }
+    }
+
+    return true;
+}
+
+
 void Solver::assignParts() {
   resetParts();
   for (int i = 0; i < clauses.size(); i++){
@@ -1846,6 +2846,8 @@ static double luby(double y, int x){
 // NOTE: assumptions passed in member-variable 'assumptions'.
 lbool Solver::solve_()
 {
+    PhaseTimer timer(stat, phase_Search);
+    assert(bulk_clauses < 0);
     model.clear();
     conflict.clear();
 
@@ -1857,8 +2859,17 @@ lbool Solver::solve_()
     }
     if (!ok) return l_False;
 
+    // -- the levels of the assumptions that this call shares with the last one are kept
+    int shared = 0;
+    while (shared < decisionLevel() && shared < assumptions.size() && assumptions[shared] == kept_assumps[shared])
+        shared++;
+    cancelUntil(shared);
+
     solves++;
 
+    if (part_bias < 1 && !vmtf) partBumpScale();
+    else                        bump_scale.clear();
+
     max_learnts               = nClauses() * learntsize_factor;
     learntsize_adjust_confl   = learntsize_adjust_start_confl;
     learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
@@ -1877,6 +2888,7 @@ lbool Solver::solve_()
         double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
         status = search(rest_base * restart_first);
         if (!withinBudget()) break;
+        if (status == l_Undef && exchange != NULL && !importClauses()) status = l_False;
         curr_restarts++;
     }
 
@@ -1891,7 +2903,8 @@ lbool Solver::solve_()
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
 
-    cancelUntil(0);
+    cancelUntil(ok && reuse_trail ? std::min(decisionLevel(), assumptions.size()) : 0);
+    assumptions.copyTo(kept_assumps);
     return status;
 }
 
@@ -1933,6 +2946,8 @@ void Solver::toDimacs(const char *file, const vec<Lit>& assumps)
 
 void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 {
+    cancelUntil(0);
+
     // Handle case when solver is in contradictory state:
     if (!ok){
         fprintf(f, "p cnf 1 2\n1 0\n-1 0\n");
@@ -1979,11 +2994,230 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 }
 
 
+//=================================================================================================
+// Snapshots:
+//
+// A snapshot starts with a header, followed by the sections of 'writeState()'. The clause arena
+// comes last, on a page boundary, so that 'loadState()' can map it instead of reading it. The file
+// is extended beyond the arena by a hole that leaves the mapped region room to grow.
+
+struct StateHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t cref_size;     // Layout of the arena and the watch lists the file was written with.
+    uint32_t watcher_size;
+    uint32_t proof;         // Does the file hold a proof?
+    uint64_t arena_off;
+    uint64_t arena_size;    // In units of the arena.
+    uint64_t arena_room;
+    uint64_t arena_wasted;
+};
+
+static const char     state_magic[8] = { 'M', 'I', 'N', 'I', 'S', 'A', 'T', 'S' };
+static const uint32_t state_version  = 4;
+
+
+bool Solver::saveState(const char* file)
+{
+    cancelUntil(0);
+
+    // -- spilled proof clauses live in a temporary file, and a bulk load is not attached yet
+    if (spill_pos.size() > 0 || bulk_clauses >= 0) return false;
+
+    FILE* f = fopen(file, "wb");
+    if (f == NULL) return false;
+    watches.cleanAll();
+
+    StateHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, state_magic, sizeof(hdr.magic));
+    hdr.version      = state_version;
+    hdr.cref_size    = sizeof(CRef);
+    hdr.watcher_size = sizeof(Watcher);
+    hdr.proof        = log_proof;
+    hdr.arena_size   = ca.size();
+    hdr.arena_wasted = ca.wasted();
+    hdr.arena_room   = ca.size() + (ca.size() / 2 > 1024*1024 ? ca.size() / 2 : 1024*1024);
+    if (hdr.arena_room >= (uint64_t)CRef_Undef) hdr.arena_room = ca.size();
+
+    StateFile out(f);
+    out.put(hdr);
+    writeState(out);
+
+    uint64_t page = sysconf(_SC_PAGESIZE);
+    long     pos  = ftell(f);
+    bool     ok   = out.ok && pos >= 0;
+    if (ok){
+        hdr.arena_off = ((uint64_t)pos + page - 1) / page * page;
+        ok = fseek(f, hdr.arena_off, SEEK_SET) == 0
+          && (ca.size() == 0 || fwrite(ca.lea(0), ClauseAllocator::Unit_Size, ca.size(), f) == (size_t)ca.size())
+          && fflush(f) == 0
+          && ftruncate(fileno(f), hdr.arena_off + hdr.arena_room * ClauseAllocator::Unit_Size) == 0
+          && fseek(f, 0, SEEK_SET) == 0
+          && fwrite(&hdr, sizeof(hdr), 1, f) == 1; }
+
+    if (fclose(f) != 0) ok = false;
+    if (!ok) ::remove(file);
+    return ok;
+}
+
+
+bool Solver::loadState(const char* file)
+{
+    assert(nVars() == 0 && clauses.size() == 0 && learnts.size() == 0 && proof.size() == 0);
+
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) return false;
+
+    StateHeader hdr;
+    struct stat st;
+    if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) || fstat(fd, &st) != 0 ||
+        memcmp(hdr.magic, state_magic, sizeof(hdr.magic)) != 0 || hdr.version != state_version ||
+        hdr.cref_size != sizeof(CRef) || hdr.watcher_size != sizeof(Watcher) || hdr.proof != (uint32_t)log_proof ||
+        hdr.arena_size > hdr.arena_room || hdr.arena_room >= (uint64_t)CRef_Undef || hdr.arena_off < sizeof(hdr) ||
+        (uint64_t)st.st_size < hdr.arena_off + hdr.arena_room * ClauseAllocator::Unit_Size){
+        close(fd);
+        return false; }
+
+    // -- the sections are copied out of a temporary mapping, the arena stays mapped copy-on-write
+    size_t arena_bytes = hdr.arena_room * ClauseAllocator::Unit_Size;
+    void*  sections    = mmap(NULL, hdr.arena_off, PROT_READ, MAP_PRIVATE, fd, 0);
+    void*  arena       = mmap(NULL, arena_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, hdr.arena_off);
+    close(fd);
+    if (sections == MAP_FAILED || arena == MAP_FAILED){
+        if (sections != MAP_FAILED) munmap(sections, hdr.arena_off);
+        if (arena    != MAP_FAILED) munmap(arena, arena_bytes);
+        return false; }
+
+    StateFile in((const char*)sections + sizeof(hdr), (const char*)sections + hdr.arena_off);
+    readState(in);
+    munmap(sections, hdr.arena_off);
+    if (!in.ok){
+        munmap(arena, arena_bytes);
+        return false; }
+
+    ca.adopt((uint32_t*)arena, hdr.arena_size, hdr.arena_room, hdr.arena_wasted);
+    return true;
+}
+
+
+void Solver::writeState(StateFile& f)
+{
+    f.put(ok);
+    f.put(ca.extra_clause_field);
+    f.put(clauses);
+    f.put(learnts);
+    f.put(learnts_core);
+    if (log_proof){
+        f.put(proof);
+        f.put(valid_lim);
+        f.put(valid_done); }
+
+    f.put(assigns);
+    f.put(vardata);
+    f.put(trail);
+    f.put(qhead);
+    f.put(trail_part);
+    f.put(partInfo);
+    f.put(activity);
+    f.put(polarity);
+    f.put(decision);
+    f.put(watches_ordered);
+    f.put(watch_unsorted);
+    for (int i = 0; i < 2*nVars(); i++){
+        watches[toLit(i)].copyTo(watch_tmp);
+        f.put(watch_tmp); }
+
+    f.put(cla_inc);
+    f.put(var_inc);
+    f.put(vmtf_links);
+    f.put(vmtf_first);
+    f.put(vmtf_last);
+    f.put(vmtf_stamp);
+    f.put(simpDB_assigns);
+    f.put(simpDB_props);
+    f.put(remove_satisfied);
+    f.put(max_learnts);
+    f.put(learntsize_adjust_confl);
+    f.put(learntsize_adjust_cnt);
+    f.put(currentPart);
+    f.put(totalPart);
+    f.put(confl_assumps);
+
+    f.put(solves);           f.put(starts);           f.put(decisions);    f.put(rnd_decisions);
+    f.put(propagations);     f.put(conflicts);        f.put(dec_vars);     f.put(clauses_literals);
+    f.put(learnts_literals); f.put(max_literals);     f.put(tot_literals);
+}
+
+
+void Solver::readState(StateFile& f)
+{
+    f.get(ok);
+    f.get(ca.extra_clause_field);
+    f.get(clauses);
+    f.get(learnts);
+    f.get(learnts_core);
+    if (log_proof){
+        f.get(proof);
+        f.get(valid_lim);
+        f.get(valid_done); }
+
+    f.get(assigns);
+    f.get(vardata);
+    f.get(trail);
+    f.get(qhead);
+    f.get(trail_part);
+    f.get(partInfo);
+    f.get(activity);
+    f.get(polarity);
+    f.get(decision);
+    f.get(watches_ordered);
+    f.get(watch_unsorted);
+    for (int i = 0; i < 2*nVars(); i++){
+        watches.init(toLit(i));
+        f.get(watch_tmp);
+        WatchList ws = watches[toLit(i)];
+        ws.capacity(watch_tmp.size());
+        for (int j = 0; j < watch_tmp.size(); j++) ws.push(watch_tmp[j]); }
+
+    f.get(cla_inc);
+    f.get(var_inc);
+    f.get(vmtf_links);
+    f.get(vmtf_first);
+    f.get(vmtf_last);
+    f.get(vmtf_stamp);
+    f.get(simpDB_assigns);
+    f.get(simpDB_props);
+    f.get(remove_satisfied);
+    f.get(max_learnts);
+    f.get(learntsize_adjust_confl);
+    f.get(learntsize_adjust_cnt);
+    f.get(currentPart);
+    f.get(totalPart);
+    f.get(confl_assumps);
+
+    f.get(solves);           f.get(starts);           f.get(decisions);    f.get(rnd_decisions);
+    f.get(propagations);     f.get(conflicts);        f.get(dec_vars);     f.get(clauses_literals);
+    f.get(learnts_literals); f.get(max_literals);     f.get(tot_literals);
+
+    // -- everything else that is kept per variable is derived, the heap is built as 'simplify()' builds it
+    seen.growTo(nVars(), 0);
+    lbd_levels.growTo(nVars() + 1, 0);
+    trail.capacity(nVars());
+    rebuildOrderHeap();
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
 void Solver::relocAll(ClauseAllocator& to)
 {
+    // -- 'validate()' ends the proof with 0 after the final conflict under assumptions
+    int proof_end = proof.size();
+    if (confl_assumps != CRef_Undef && proof_end >= 2 && proof[proof_end-1] == 0 && proof[proof_end-2] == confl_assumps)
+        proof_end--;
+
     // All watchers:
     //
     // for (int i = 0; i < watches.size(); i++)
@@ -1992,10 +3226,11 @@ void Solver::relocAll(ClauseAllocator& to)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
             // printf(" >>> RELOCING: %s%d\n", sign(p)?"-":"", var(p)+1);
-            vec<Watcher>& ws = watches[p];
+            WatchList ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
         }
+    watches.compact();
 
     // All reasons:
     //
@@ -2016,17 +3251,176 @@ void Solver::relocAll(ClauseAllocator& to)
     for (int i = 0; i < clauses.size(); i++)
         ca.reloc(clauses[i], to);
 
+    // Final conflict under assumptions:
+    //
+    if (confl_assumps != CRef_Undef)
+      ca.reloc (confl_assumps, to);
+
+    // Paged in spilled clauses:
+    //
+    for (int i = 0; i < spill_cref.size (); i++)
+      if (spill_cref[i] != CRef_Undef)
+        ca.reloc (spill_cref[i], to);
+
     // Clausal proof:
     //
-    for (int i = 0; i < proof.size (); i++)
-      ca.reloc (proof[i], to);
+    for (int i = 0; i < proof_end; i++)
+      if (proof_spill) spillClause (proof[i], to);
+      else             ca.reloc (proof[i], to);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  spillClause : (cr : CRef&) (to : ClauseAllocator&)  ->  [void]
+|
+|  Description:
+|    Relocates the proof clause 'cr' to 'to'. A deleted clause that is not referenced from
+|    anywhere but the proof is appended to 'spill_file' instead, and only a stub recording its
+|    position on disk is left in 'to'. The clause is loaded again by 'pageIn()' when 'validate()'
+|    reaches it, i.e., the file is read back from the end.
+|________________________________________________________________________________________________@*/
+void Solver::spillClause(CRef& cr, ClauseAllocator& to)
+{
+    Clause& c = ca[cr];
+    if (c.reloced() || c.mark() != 1 || c.spilled()) { ca.reloc(cr, to); return; }
+    if (spill_file == NULL && (spill_file = tmpfile()) == NULL) { ca.reloc(cr, to); return; }
+
+    uint32_t hdr[2] = { (uint32_t)c.size(), (uint32_t)c.learnt() };
+    fseek(spill_file, 0, SEEK_END);
+    int64_t  pos = ftell(spill_file);
+    if (pos < 0 || fwrite(hdr, sizeof(uint32_t), 2, spill_file) != 2 ||
+        fwrite((const Lit*)c, sizeof(Lit), c.size(), spill_file) != (size_t)c.size()){
+        // -- keep the clause in memory if the file can not be written
+        ca.reloc(cr, to); return; }
+
+    spill_pos.push(pos);
+    spill_cref.push(CRef_Undef);
+
+    vec<Lit> stub;
+    stub.push(toLit(spill_pos.size() - 1));
+    CRef scr = to.alloc(stub, c.learnt());
+    to[scr].mark(1);
+    to[scr].core(c.core());
+    to[scr].part(c.part());
+    to[scr].spilled(1);
+    c.relocate(scr);
+    cr = scr;
+}
+
+
+CRef Solver::pageIn(CRef cr)
+{
+    // -- the stub keeps the partition and core flag of the clause up to date
+    const Clause& stub = ca[cr];
+    assert(stub.spilled());
+    int   idx  = toInt(stub[0]);
+    bool  core = stub.core();
+    Range part = stub.part();
+    if (spill_cref[idx] != CRef_Undef) return spill_cref[idx];
+
+    uint32_t hdr[2];
+    fseek(spill_file, spill_pos[idx], SEEK_SET);
+    if (fread(hdr, sizeof(uint32_t), 2, spill_file) != 2)
+        throw std::runtime_error("Failed to read spilled proof clause.");
+    vec<Lit> lits(hdr[0]);
+    if (fread((Lit*)lits, sizeof(Lit), lits.size(), spill_file) != (size_t)lits.size())
+        throw std::runtime_error("Failed to read spilled proof clause.");
+
+    CRef ncr = ca.alloc(lits, hdr[1]);
+    ca[ncr].mark(1);
+    ca[ncr].core(core);
+    ca[ncr].part(part);
+    spill_cref[idx] = ncr;
+    return ncr;
 }
 
 
+void Solver::pageOut(int i)
+{
+    Clause& stub = ca[proof[i]];
+    if (!stub.spilled()) return;
+    int idx = toInt(stub[0]);
+    if (spill_cref[idx] == CRef_Undef) return;
+
+    const Clause& c = ca[spill_cref[idx]];
+    assert(c.mark() == 1);
+    stub.core(c.core());
+    stub.part(c.part());
+    ca.free(spill_cref[idx]);
+    spill_cref[idx] = CRef_Undef;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  trimProof : ()  ->  [void]
+|
+|  Description:
+|    Removes the addition and the deletion step of deleted proof clauses that are not core from
+|    the proof, so that the next garbage collection reclaims them. A later validation checks a
+|    lemma against the clauses that were alive when it was added, so a clause is only dropped
+|    if no lemma that may still be checked was added while it was alive. Those are the lemmas
+|    that were not validated yet and are alive, core or locked, and, in turn, the deleted ones
+|    that were alive when such a lemma was added. Steps are paired by the clause they refer to:
+|    the first step of a clause is its addition, a second one its deletion.
+|________________________________________________________________________________________________@*/
+void Solver::trimProof()
+{
+    // -- the final conflict under assumptions stays at the end
+    int end = proof.size();
+    if (confl_assumps != CRef_Undef && end >= 2 && proof[end-1] == 0 && proof[end-2] == confl_assumps)
+        end--;
+
+    // -- the other step of the clause of each step, or -1
+    vec<int>            other(end, -1);
+    RefTable<CRef, int> first(-1);
+    for (int i = 0; i < end; i++){
+        int j;
+        if (first.has(proof[i], j)) other[i] = j, other[j] = i;
+        else                        first.insert(proof[i], i); }
+
+    // -- walk back, counting the additions of lemmas that may still be checked
+    vec<int>  pending(end, 0);   // -- the count at each deletion step
+    vec<char> drop(end, 0);
+    int       n = 0;
+    for (int i = end - 1; i >= 0; i--){
+        int j = other[i];
+        if (j >= 0 && j < i) { pending[i] = n; continue; }
+        if (i < valid_done.size() && valid_done[i]) continue;
+        if (j < 0) { n++; continue; }
+
+        const Clause* c = &ca[proof[i]];
+        if (c->spilled() && spill_cref[toInt((*c)[0])] != CRef_Undef)
+            c = &ca[spill_cref[toInt((*c)[0])]];
+        if (n > pending[j] || c->core() || (!c->spilled() && locked(*c)) || proof[i] == confl_assumps) { n++; continue; }
+        drop[i] = drop[j] = 1;
+    }
+
+    int j = 0, lim = 0, done = 0;
+    for (int i = 0; i < proof.size(); i++){
+        if (i < end && drop[i]){
+            // -- a paged in copy is not referenced from anywhere else
+            const Clause& c = ca[proof[i]];
+            if (c.spilled() && spill_cref[toInt(c[0])] != CRef_Undef){
+                ca.free(spill_cref[toInt(c[0])]);
+                spill_cref[toInt(c[0])] = CRef_Undef; }
+            continue; }
+        if (i < valid_lim) lim++;
+        if (i < valid_done.size()) valid_done[done++] = valid_done[i];
+        proof[j++] = proof[i];
+    }
+    if (verbosity >= 2)
+        printf("|  Proof trimming:       %12d steps => %12d steps             |\n", proof.size(), j);
+    proof.shrink(proof.size() - j);
+    valid_done.shrink(valid_done.size() - done);
+    valid_lim = lim;
+}
 
 
 void Solver::garbageCollect()
 {
+    PhaseTimer timer(stat, phase_GC);
     //assert (!log_proof);
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
@@ -2034,83 +3428,51 @@ void Solver::garbageCollect()
 
     relocAll(to);
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n",
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n",
+               (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
+    stat.collected((uint64_t)(ca.size() - to.size())*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
 
+// Whether the 'n' literals of 'first' are the first 'n' of the 'm' literals of 'second' once both
+// are sorted. Signatures reject most pairs before anything is copied.
+bool Solver::sortedPrefix(const Lit* first, int n, const Lit* second, int m) const
+{
+  if (n > m || (litSignature(first, n) & ~litSignature(second, m)) != 0)
+    return false;
+
+  compare_first.clear();
+  for (int i = 0; i < n; ++i)
+    compare_first.push(first[i]);
+  sort(compare_first);
+
+  compare_second.clear();
+  for (int i = 0; i < m; ++i)
+    compare_second.push(second[i]);
+  sort(compare_second);
+
+  return equalLits(compare_first, compare_second, n);
+}
+
 bool Solver::clausesAreEqual(CRef first, CRef second) const
 {
   const Clause& first_clause = ca[first];
   const Clause& second_clause = ca[second];
-  if (first_clause.size() == second_clause.size())
-  {
-    vec<Lit> sortedFirstCopy (first_clause.size ());
-    for (int i = 0; i < first_clause.size (); ++i)
-      sortedFirstCopy[i] = first_clause[i];
-    sort(sortedFirstCopy);
-
-    vec<Lit> sortedSecondCopy (second_clause.size ());
-    for (int i = 0; i < second_clause.size (); ++i)
-      sortedSecondCopy[i] = second_clause[i];
-    sort(sortedSecondCopy);
-
-    for (int i=0; i < first_clause.size(); i++)
-      if (sortedFirstCopy[i] != sortedSecondCopy[i])
-        return false;
-  } else {
-    return false;
-  }
-
-  return true;
+  return first_clause.size() == second_clause.size() &&
+         sortedPrefix(first_clause, first_clause.size(), second_clause, second_clause.size());
 }
 
 bool Solver::clauseSubsumes(CRef first, CRef second) const {
   const Clause& first_clause = ca[first];
   const Clause& second_clause = ca[second];
-  if (first_clause.size() <= second_clause.size())
-  {
-    vec<Lit> sortedFirstCopy (first_clause.size ());
-    for (int i = 0; i < first_clause.size (); ++i)
-      sortedFirstCopy[i] = first_clause[i];
-    sort(sortedFirstCopy);
-
-    vec<Lit> sortedSecondCopy (second_clause.size ());
-    for (int i = 0; i < second_clause.size (); ++i)
-      sortedSecondCopy[i] = second_clause[i];
-    sort(sortedSecondCopy);
-
-    for (int i=0; i < first_clause.size(); i++)
-      if (sortedFirstCopy[i] != sortedSecondCopy[i])
-        return false;
-  } else {
-    return false;
-  }
-
-  return true;
+  return sortedPrefix(first_clause, first_clause.size(), second_clause, second_clause.size());
 }
 
 bool Solver::clausesAreEqual(CRef orig, const vec<Lit>& lits) const
 {
   const Clause& original = ca[orig];
-  if (lits.size() == original.size())
-  {
-    vec<Lit> sortedOriginalCopy (original.size ());
-    for (int i = 0; i < original.size (); ++i)
-      sortedOriginalCopy [i] = original [i];
-    sort(sortedOriginalCopy);
-
-    vec<Lit> sortedLearntCopy;
-    lits.copyTo(sortedLearntCopy);
-    sort(sortedLearntCopy);
-
-    for (int i=0; i < lits.size(); i++)
-      if (sortedOriginalCopy[i] != sortedLearntCopy[i])
-        return false;
-  }
-  else return false;
-
-  return true;
+  return lits.size() == original.size() &&
+         sortedPrefix(original, original.size(), lits, lits.size());
 }
 
 void Solver::resetSolver() {
@@ -21,16 +21,22 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include <stdio.h>
+
 #include "mtl/Vec.h"
 #include "mtl/Heap.h"
 #include "mtl/Alg.h"
 #include "utils/Options.h"
 #include "core/SolverTypes.h"
+#include "core/ProofVisitor.h"
+#include "core/SolverStats.h"
 
 
 namespace Minisat {
 
-class ProofVisitor;
+struct ProofTable;
+struct StateFile;
+class  ClauseExchange;
 
 //=================================================================================================
 // Solver -- the main class:
@@ -55,6 +61,8 @@ public:
   bool addClause_ (vec<Lit> &ps);
   bool    addClause_(      vec<Lit>& ps, Range part);                     // Add a clause to the solver without making superflous internal copy. Will
                                                                 // change the passed vector 'ps'.
+    void    beginClauses (int n, uint64_t lits);                // Start adding about 'n' clauses with 'lits' literals in total. Their watchers are attached,
+    bool    commitClauses();                                    // and the units among them propagated, only by 'commitClauses()'.
 
     // Solving:
     //
@@ -66,6 +74,7 @@ public:
     bool    solve        (Lit p, Lit q);            // Search for a model that respects two assumptions.
     bool    solve        (Lit p, Lit q, Lit r);     // Search for a model that respects three assumptions.
     bool    okay         () const;                  // FALSE means solver is in a conflicting state
+    Var     splitVar     (const vec<Lit>& cube);    // The decision variable the search favours most, outside 'cube' and the root level (for 'CubeAndConquer').
 
     void    toDimacs     (FILE* f, const vec<Lit>& assumps);            // Write CNF to file in DIMACS-format.
     void    toDimacs     (const char *file, const vec<Lit>& assumps);
@@ -77,9 +86,16 @@ public:
     void    toDimacs     (const char* file, Lit p, Lit q);
     void    toDimacs     (const char* file, Lit p, Lit q, Lit r);
 
+    // Snapshots of the solver state:
+    //
+    bool    saveState    (const char* file);    // Write the state at decision level 0, with the proof if it is logged, to 'file'.
+    bool    loadState    (const char* file);    // Take over the state in 'file'. The solver must not have any variables yet.
+
     // Proof validation / traversal
     bool    validate ();  // validates clausal proof
     void    replay (ProofVisitor& v,  vec<CRef>* pOldProof = NULL); // replays clausal proof AFTER validation
+    lbool   validateLimited ();                                               // As 'validate()', but stops within the budget and goes on with the next call (l_Undef).
+    lbool   replayLimited   (ProofVisitor& v,  vec<CRef>* pOldProof = NULL); // As 'replay()', but stops within the budget and goes on with the next call (l_Undef).
     void    runProof();
 
     bool    proofLogging () { return log_proof;}
@@ -97,6 +113,10 @@ public:
     void labelFinal(ProofVisitor& v, CRef confl);
     CRef fixrec(ProofVisitor& v, CRef anchor, int part);
     bool traverse(ProofVisitor& v, CRef proofClause, CRef reason, int part, vec<Lit>& out_learnt, Range& range);
+    void visitChain(ProofVisitor& v, ProofStep::Kind kind, Lit lit, CRef cr, int pbase, int cbase);
+    bool fixValid(CRef anchor, int part, int e) const;
+    void fixRecord(CRef anchor, int part, CRef resolvent, int pbase, int cbase);
+    void fixClear(bool dealloc);
 
     // Variable mode:
     // 
@@ -105,7 +125,7 @@ public:
 
     // Read state:
     //
-    lbool   value      (Var x) const;       // The current value of a variable.
+    lbool   value      (Var x) const;       // The current value of a variable (after 'solve()', the assumptions may still be assigned).
     lbool   value      (Lit p) const;       // The current value of a literal.
     lbool   modelValue (Var x) const;       // The value of a variable in the last model. The last call to solve must have been satisfiable.
     lbool   modelValue (Lit p) const;       // The value of a literal in the last model. The last call to solve must have been satisfiable.
@@ -128,6 +148,7 @@ public:
     virtual void garbageCollect();
     void    checkGarbage(double gf);
     void    checkGarbage();
+    void    reserveClauses(int n, uint64_t lits); // Room for 'n' more problem clauses with 'lits' literals in total.
 
     // Extra results: (read-only member variable)
     //
@@ -139,7 +160,14 @@ public:
     //
     int       verbosity;
     bool      log_proof; // Enable proof logging 
+    bool      proof_spill;        // Move deleted proof clauses to a temporary file during garbage collection.
+    bool      proof_trim;         // Drop the deleted proof clauses that validation can not need any more after 'validate()'.
+    bool      valid_incr;         // Let 'validate()' start from the previous checkpoint and leave the database ready for solving.
+    int       valid_threads;      // Number of threads that check lemmas in 'validate()'.
     bool      ordered_propagate;
+    ClauseExchange* exchange;     // Learnt clauses are exported to and imported from it at restarts (see 'Portfolio'), unless NULL.
+    int       exchange_id;        // Ring of this solver in 'exchange'.
+    int       share_lim;          // Export learnt clauses of at most this many literals.
     double    var_decay;
     double    clause_decay;
     double    random_var_freq;
@@ -149,7 +177,12 @@ public:
     int       phase_saving;       // Controls the level of phase saving (0=none, 1=limited, 2=full).
     bool      rnd_pol;            // Use random polarities for branching heuristics.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
+    bool      vmtf;               // Decide on the most recently bumped variable (VMTF) instead of the most active one (VSIDS).
+    double    part_bias;          // Scale the activity bumps of a variable by this factor per partition above the first (VSIDS only, 1 = off).
+    bool      reuse_trail;        // Keep the assumptions assigned across restarts and for the next 'solve()' (see 'restartLevel()').
     double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
+    int       core_lbd;           // Learnt clauses of at most this LBD are never removed by 'reduceDB()'.                     (default 2)
+    int       tier2_lbd;          // Learnt clauses of at most this LBD are kept while they take part in conflicts.           (default 6)
 
     int       restart_first;      // The initial restart limit.                                                                (default 100)
     double    restart_inc;        // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
@@ -164,6 +197,8 @@ public:
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
 
+    const SolverStats& stats () const   { return stat; }   // Phase times and per partition counters (needs MINISAT_STATS).
+
     void     setCurrentPart(unsigned n) { currentPart = n;        }
     unsigned getCurrentPart ()          { return currentPart;     }
     Range    getTotalPart ()            { return totalPart;       }
@@ -194,10 +229,13 @@ protected:
     static inline VarData mkVarData(CRef cr, int l){ VarData d = {cr, l}; return d; }
 
     struct Watcher {
-        CRef cref;
-        Lit  blocker;
-        Watcher () : cref(CRef_Undef), blocker(lit_Undef) {}
-        Watcher(CRef cr, Lit p) : cref(cr), blocker(p) {}
+        CRef     cref;
+        Lit      blocker;
+        unsigned part   : 30; // Maximal partition of the watched clause (used by ordered propagation).
+        unsigned core   : 1;  // Core flag of the watched clause (used by core-only propagation).
+        unsigned binary : 1;  // The watched clause is binary, 'blocker' is its other literal.
+        Watcher () : cref(CRef_Undef), blocker(lit_Undef), part(Range::part_Undef), core(0), binary(0) {}
+        Watcher(CRef cr, Lit p, const Clause& c) : cref(cr), blocker(p), part(c.part().max()), core(c.core()), binary(c.size() == 2) {}
         bool operator==(const Watcher& w) const { return cref == w.cref; }
         bool operator!=(const Watcher& w) const { return cref != w.cref; }
     };
@@ -209,6 +247,8 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
+    typedef ArenaLists<Lit, Watcher, WatcherDeleted>::List WatchList;
+
     struct WatcherLt
     {
       const ClauseAllocator& ca;
@@ -216,6 +256,13 @@ protected:
       bool operator () (Watcher const &x, Watcher const &y)
       { return x.cref > y.cref; }
     };
+
+    /// -- orders watchers by the maximal partition of the watched clause
+    struct WatcherPartLt
+    {
+      bool operator () (Watcher const &x, Watcher const &y)
+      { return x.part < y.part; }
+    };
     
     struct VarOrderLt {
         const vec<double>&  activity;
@@ -223,6 +270,18 @@ protected:
         VarOrderLt(const vec<double>&  act) : activity(act) { }
     };
 
+    // A variable in the VMTF queue, which links all variables in the order they were last bumped in:
+    struct VmtfLink {
+        Var      prev, next;
+        uint64_t stamp;           // Time of the last bump, increasing along the queue.
+    };
+
+    struct VmtfStampLt {
+        const vec<VmtfLink>& links;
+        bool operator () (Var x, Var y) const { return links[x].stamp < links[y].stamp; }
+        VmtfStampLt(const vec<VmtfLink>& l) : links(l) { }
+    };
+
     struct LitOrderLt {
         const vec<VarData>& vardata;
         const vec<lbool>&   assigns;
@@ -259,13 +318,38 @@ protected:
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     vec<CRef>           clauses;          // List of problem clauses.
     vec<CRef>           learnts;          // List of learnt clauses.
+    int                 learnts_core;     // Number of learnt clauses in the core tier (see 'reduceDB()').
     vec<CRef>           proof;            // Clausal proof
+    SolverStats         stat;             // Instrumentation, see 'stats()'.
+    FILE*               spill_file;       // Temporary file holding the spilled proof clauses (see 'spillClause()').
+    vec<int64_t>        spill_pos;        // 'spill_pos[i]' is the offset of the i'th spilled clause in 'spill_file'.
+    vec<CRef>           spill_cref;       // 'spill_cref[i]' is the paged in copy of the i'th spilled clause, or CRef_Undef.
+    int                 valid_lim;        // Checkpoint of 'validate()': the proof steps before it were validated already.
+    vec<char>           valid_done;       // 'valid_done[i]' is set if proof step 'i' is a core lemma that was validated.
+    int                 walk_pos;         // Proof step at which a budgeted 'validateSteps()' stopped, or -1 if none did.
+    int                 walk_walked;      // The 'walked' and 'lim' of that walk.
+    int                 walk_lim;
+    int                 replay_pos;       // Proof step at which a budgeted 'replay_()' stopped, or -1 if none did.
+    vec<CRef>           replay_proof;     // The new proof built by that replay so far.
     vec<Range>          trail_part;       // Partition of variables on the trail
+    vec<ProofStep>      step_buf;         // Steps of the current batch of 'labelLevel0()'.
+    vec<Lit>            step_pivots;      // Pivots of the steps handed to the proof visitor, and of the chains being built by 'traverse()'.
+    vec<CRef>           step_clauses;     // Antecedents of the steps handed to the proof visitor, and of the chains being built by 'traverse()'.
+
+    // Resolvents created by 'fixrec()' in the current replay, to reuse them for the same anchor:
+    struct FixEntry { CRef resolvent; int part; int start, size; };
+    RefTable<CRef, int> fix_cache;        // 'fix_cache[anchor]' is the index in 'fix_entries' of the last resolvent created for 'anchor', or -1.
+    vec<FixEntry>       fix_entries;
+    vec<Lit>            fix_pivots;       // 'fix_pivots[start..start+size)' are the pivots of the chain of an entry,
+    vec<CRef>           fix_reasons;      // and 'fix_reasons[..]' the reasons they were resolved with.
     double              cla_inc;          // Amount to bump next clause with.
     vec<double>         activity;         // A heuristic measurement of the activity of a variable.
+    vec<double>         bump_scale;       // 'bump_scale[v]' scales the activity bumps of 'v' (see 'part_bias'), or empty if they are not scaled.
     double              var_inc;          // Amount to bump next variable with.
-    OccLists<Lit, vec<Watcher>, WatcherDeleted>
+    ArenaLists<Lit, Watcher, WatcherDeleted>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    bool                watches_ordered;  // Indicates whether every watch list is sorted by partition (see 'propagateOrdered()').
+    vec<int>            watch_unsorted;   // 'watch_unsorted[lit]' bounds the number of watchers at the end of 'watches[lit]' that may be out of partition order.
     vec<lbool>          assigns;          // The current assignments.
     vec<char>           polarity;         // The preferred polarity of each variable.
     vec<char>           decision;         // Declares if a variable is eligible for selection in the decision heuristic.
@@ -273,10 +357,18 @@ protected:
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<VarData>        vardata;          // Stores reason and level for each variable.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
+    int                 bulk_clauses;     // First clause of the bulk load started by 'beginClauses()', or -1.
+    int                 bulk_trail;       // First unit of that bulk load on the trail.
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
-    Heap<VarOrderLt>    order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    vec<Lit>            kept_assumps;     // Assumptions of the last 'solve()', the first 'decisionLevel()' of them are still assigned.
+    Heap<VarOrderLt, 4> order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    vec<VmtfLink>       vmtf_links;       // The VMTF queue, used instead of 'order_heap' if 'vmtf' is set.
+    Var                 vmtf_first;       // Least recently bumped variable.
+    Var                 vmtf_last;        // Most recently bumped variable.
+    Var                 vmtf_search;      // No variable after it in the queue is an unassigned decision variable.
+    uint64_t            vmtf_stamp;       // Stamp of the last bump.
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
 
@@ -289,6 +381,17 @@ protected:
     vec<Lit>            analyze_stack;
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
+    vec<vec<Lit> >      part_queue;
+    vec<int>            part_qhead;
+    vec<int>            part_rpos;
+    vec<int>            part_wpos;
+    vec<Watcher>        watch_tmp;
+    vec<Lit>            import_tmp;
+    mutable vec<Lit>    compare_first;    // Sorted copies of the clauses compared by 'clausesAreEqual()' and 'clauseSubsumes()'.
+    mutable vec<Lit>    compare_second;
+    vec<Var>            vmtf_bumped;
+    vec<uint64_t>       lbd_levels;
+    uint64_t            lbd_stamp;
 
     double              max_learnts;
     double              learntsize_adjust_confl;
@@ -315,9 +418,16 @@ protected:
     Lit      pickBranchLit    ();                                                      // Return the next decision variable.
     void     newDecisionLevel ();                                                      // Begins a new decision level.
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
+    void     uncheckedEnqueueBinary (Lit p, CRef from);                                // Enqueue a literal implied by a binary clause. Assumes value of literal is undefined.
+    void     normalizeBinary  (Lit p, CRef cr);                                        // Move literal 'p' of a binary clause to the front.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        (bool coreOnly = false, int maxPart = 0);                                                      // Perform unit propagation. Returns possibly conflicting clause.
+    template<bool CoreOnly, bool Bounded>
+    CRef     propagate_       (int maxPart);                                           // Unit propagation specialized for a mode of 'propagate()'.
+    template<bool CoreOnly>
+    CRef     propagateOrdered ();                                                      // Unit propagation that prefers clauses from lower partitions.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
+    int      restartLevel     ()      const;                                           // Level that a restart backtracks to.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel, 
                                Range &part);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict, Range& part);            // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
@@ -329,23 +439,53 @@ protected:
     void     rebuildOrderHeap ();
 
     bool     validateLemma (CRef c);
+    lbool    validate_     (bool budgeted);
+    lbool    replay_       (ProofVisitor& v, vec<CRef>* pOldProof, bool budgeted);
     // Maintaining Variable/Clause activity:
     //
     void     varDecayActivity ();                      // Decay all variables with the specified factor. Implemented by increasing the 'bump' value instead.
     void     varBumpActivity  (Var v, double inc);     // Increase a variable with the current 'bump' value.
     void     varBumpActivity  (Var v);                 // Increase a variable with the current 'bump' value.
+    void     vmtfEnqueue      (Var v);                 // Append a variable to the VMTF queue as the most recently bumped one.
+    void     vmtfDequeue      (Var v);                 // Unlink a variable from the VMTF queue.
+    void     vmtfBump         ();                      // Move the variables in 'vmtf_bumped' to the end of the VMTF queue, keeping their order.
+    void     partBumpScale    ();                      // Compute 'bump_scale' from the partitions of the original clauses.
     void     claDecayActivity ();                      // Decay all clauses with the specified factor. Implemented by increasing the 'bump' value instead.
     void     claBumpActivity  (Clause& c);             // Increase a clause with the current 'bump' value.
+    template<class Lits>
+    unsigned computeLBD       (const Lits& c);         // Number of decision levels among the (assigned) literals of 'c'.
+    void     claSetLBD        (Clause& c, unsigned lbd); // Update the LBD of a learnt clause, promoting it to a higher tier if it qualifies.
 
     // Operations on clauses:
     //
     void     attachClause     (CRef cr);               // Attach a clause to watcher lists.
+    void     attachWatch      (Lit p, const Watcher& w); // Add 'w' to the watch list of 'p'.
+    void     joinPart         (CRef cr, const Range& r); // Extend the partition of a (possibly attached) clause.
+    void     syncWatch        (Lit p, Watcher& w, const Clause& c); // Copy partition and core flag of 'c' into 'w'.
+    void     syncWatches      (CRef cr);               // Refresh the watchers of a clause after its partition or core flag changed.
+    void     syncWatches      ();                      // Refresh all watchers.
+    void     orderWatches     ();                      // Sort all watch lists by partition.
+    void     orderWatches     (Lit p);                 // Restore the partition order of the watch list of 'p'.
     void     detachClause     (CRef cr, bool strict = false); // Detach a clause to watcher lists.
     void     removeClause     (CRef cr);               // Detach and free a clause.
     bool     locked           (const Clause& c) const; // Returns TRUE if a clause is a reason for some implication in the current state.
     bool     satisfied        (const Clause& c) const; // Returns TRUE if a clause is satisfied in the current state.
 
     void     relocAll         (ClauseAllocator& to);
+    void     spillClause      (CRef& cr, ClauseAllocator& to); // Move a deleted proof clause to disk, leaving a stub in 'to'.
+    CRef     pageIn           (CRef cr);               // Load a spilled clause back into memory.
+    void     pageOut          (int i);                 // Drop the in-memory copy of a spilled clause of proof step 'i'.
+    void     trimProof        ();                      // Remove deleted non-core clauses that no later validation needs from the proof.
+    lbool    validateSteps    (int lim, bool restore, bool budgeted); // Validate the proof from its end down to step 'lim' (see 'validate()').
+    bool     pendingLemma     (int i);                 // Is proof step 'i' a core lemma that still needs validation?
+    void     restoreSteps     (int from);              // Apply the proof steps from 'from' on again after 'validateSteps()'.
+    CRef     proofStep        (int i);                 // Returns the clause of proof step 'i', paging it in if needed.
+    void     checkLemmas      (int from, ProofTable& t); // Check the lemmas from step 'from' on in parallel (see 'validateSteps()').
+    bool     markAntecedents  (const ProofTable& t, int i); // Mark the antecedents 'checkLemmas()' found for step 'i' as core.
+    bool     importClauses    ();                      // Add the clauses of 'exchange' at level 0. FALSE if they make the problem unsatisfiable.
+    Range    conflictPart     (CRef confl);            // Partition of the clauses that lead to a conflict above level 0.
+    virtual void writeState   (StateFile& f);          // Write the sections of a snapshot (see 'saveState()').
+    virtual void readState    (StateFile& f);          // Read them back (see 'loadState()').
 
     // FS:
     void     assignParts      ();                      // Assign variables part ranges.
@@ -363,6 +503,7 @@ protected:
     bool     clausesAreEqual(CRef orig, const vec<Lit>& lits) const;
     bool     clausesAreEqual(CRef first, CRef second) const;
     bool     clauseSubsumes(CRef first, CRef second) const;
+    bool     sortedPrefix   (const Lit* first, int n, const Lit* second, int m) const; // (helper method for the above)
     // Static helpers:
     //
 
@@ -386,7 +527,24 @@ inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
 
 inline void Solver::insertVarOrder(Var x) {
-    if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
+    if (vmtf){
+        if (vmtf_search == var_Undef || vmtf_links[x].stamp > vmtf_links[vmtf_search].stamp) vmtf_search = x; }
+    else if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
+
+inline void Solver::vmtfEnqueue(Var v) {
+    VmtfLink& l = vmtf_links[v];
+    l.prev  = vmtf_last;
+    l.next  = var_Undef;
+    l.stamp = ++vmtf_stamp;
+    if (vmtf_last == var_Undef) vmtf_first = v;
+    else                        vmtf_links[vmtf_last].next = v;
+    vmtf_last = v; }
+inline void Solver::vmtfDequeue(Var v) {
+    const VmtfLink& l = vmtf_links[v];
+    if (l.prev == var_Undef) vmtf_first = l.next;
+    else                     vmtf_links[l.prev].next = l.next;
+    if (l.next == var_Undef) vmtf_last = l.prev;
+    else                     vmtf_links[l.next].prev = l.prev; }
 
 inline void Solver::varDecayActivity() { var_inc *= (1 / var_decay); }
 inline void Solver::varBumpActivity(Var v) { varBumpActivity(v, var_inc); }
@@ -409,10 +567,33 @@ inline void Solver::claBumpActivity (Clause& c) {
                 ca[learnts[i]].activity() *= 1e-20;
             cla_inc *= 1e-20; } }
 
+template<class Lits>
+inline unsigned Solver::computeLBD(const Lits& c) {
+    unsigned n = 0;
+    lbd_stamp++;
+    for (int i = 0; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (lbd_levels[l] != lbd_stamp){
+            lbd_levels[l] = lbd_stamp;
+            n++; } }
+    return n; }
+inline void Solver::claSetLBD(Clause& c, unsigned lbd) {
+    unsigned t = (int)lbd <= core_lbd ? Clause::tier_Core : (int)lbd <= tier2_lbd ? Clause::tier_Two : Clause::tier_Local;
+    c.lbd(lbd);
+    if (t < c.tier()){
+        if (t == Clause::tier_Core) learnts_core++;
+        c.tier(t); } }
+
+inline CRef Solver::proofStep(int i) { return ca[proof[i]].spilled() ? pageIn(proof[i]) : proof[i]; }
+
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
     if (ca.wasted() > ca.size() * gf)
         garbageCollect(); }
+inline void Solver::reserveClauses(int n, uint64_t lits){
+    uint64_t words = (uint64_t)ca.size() + lits + (uint64_t)n * (sizeof(Clause) / sizeof(uint32_t) + 2);
+    if (words < (uint64_t)CRef_Undef) ca.reserve((CRef)words);
+    clauses.capacity(clauses.size() + n); }
 
 // NOTE: enqueue does not set the ok flag! (only public methods do)
 inline bool     Solver::enqueue         (Lit p, CRef from)      { return value(p) != l_Undef ? value(p) != l_False : (uncheckedEnqueue(p, from), true); }
@@ -424,6 +605,32 @@ inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
 inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
+inline void     Solver::attachWatch     (Lit p, const Watcher& w)
+{
+    watches[p].push(w);
+    if (ordered_propagate) watch_unsorted[toInt(p)]++;
+    else                   watches_ordered = false;
+}
+inline void     Solver::normalizeBinary (Lit p, CRef cr)
+{
+    // -- put the literal in the same position as propagation of long clauses would
+    Clause& c = ca[cr];
+    if (c[0] != p) c[1] = c[0], c[0] = p;
+}
+inline void     Solver::uncheckedEnqueueBinary (Lit p, CRef from)
+{
+    // -- the implied literal of a reason comes first (see 'analyze()')
+    normalizeBinary(p, from);
+    uncheckedEnqueue(p, from);
+}
+inline void     Solver::syncWatch       (Lit p, Watcher& w, const Clause& c)
+{
+    w.core = c.core();
+    if (w.part != (unsigned)c.part().max()){
+        w.part = c.part().max();
+        if (ordered_propagate) watch_unsorted[toInt(p)] = watches[p].size();
+        else                   watches_ordered = false; }
+}
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
 inline uint32_t Solver::abstractLevel (Var x) const   { return 1 << (level(x) & 31); }
@@ -466,6 +673,11 @@ inline bool     Solver::solve         (const vec<Lit>& assumps){ budgetOff(); as
 inline lbool    Solver::solveLimited  (const vec<Lit>& assumps){ assumps.copyTo(assumptions); return solve_(); }
 inline bool     Solver::okay          ()      const   { return ok; }
 
+inline bool     Solver::validate        ()                                       { return validate_(false) == l_True; }
+inline void     Solver::replay          (ProofVisitor& v, vec<CRef>* pOldProof)  { replay_(v, pOldProof, false); }
+inline lbool    Solver::validateLimited ()                                       { return validate_(true); }
+inline lbool    Solver::replayLimited   (ProofVisitor& v, vec<CRef>* pOldProof)  { return replay_(v, pOldProof, true); }
+
 inline void     Solver::toDimacs     (const char* file){ vec<Lit> as; toDimacs(file, as); }
 inline void     Solver::toDimacs     (const char* file, Lit p){ vec<Lit> as; as.push(p); toDimacs(file, as); }
 inline void     Solver::toDimacs     (const char* file, Lit p, Lit q){ vec<Lit> as; as.push(p); as.push(q); toDimacs(file, as); }
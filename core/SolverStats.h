@@ -0,0 +1,83 @@
+#ifndef Minisat_SolverStats_h
+#define Minisat_SolverStats_h
+
+#include <stdint.h>
+
+#include <chrono>
+
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// SolverStats -- where a solver spends its time (see 'Solver::stats()'):
+//
+// Only recorded if the solver is built with MINISAT_STATS defined, otherwise the fields stay zero
+// and the recording calls compile to nothing. Phase times are wall times and inclusive: a phase
+// that runs inside another (e.g. 'fixrec' inside 'replay') counts towards both, a phase that
+// runs inside itself only once.
+
+
+#ifdef MINISAT_STATS
+static const bool stats_enabled = true;
+#else
+static const bool stats_enabled = false;
+#endif
+
+enum Phase { phase_Search, phase_Simplify, phase_Eliminate, phase_Validate, phase_Replay,
+             phase_Level0, phase_Fixrec, phase_GC, phase_Count };
+
+static inline const char* phaseName(int p) {
+    static const char* names[phase_Count] = { "search", "simplify", "eliminate", "validate", "replay",
+                                              "labelLevel0", "fixrec", "gc" };
+    return names[p]; }
+
+
+struct SolverStats {
+    double        phase_time [phase_Count];  // Wall time spent in each phase, in seconds.
+    uint64_t      phase_calls[phase_Count];  // Number of outermost calls of each phase.
+    int           phase_depth[phase_Count];  // Number of calls of each phase that are running.
+    vec<uint64_t> part_props;                // 'part_props[p]' counts the literals implied by clauses of maximal partition 'p' (0 = none).
+    vec<uint64_t> part_conflicts;            // 'part_conflicts[p]' counts the conflicts on clauses of maximal partition 'p'.
+    uint64_t      gc_runs;                   // Number of garbage collections.
+    uint64_t      gc_bytes;                  // Bytes of the clause arena they reclaimed.
+    uint64_t      proof_steps;               // Length of the proof when it was last validated.
+    uint64_t      proof_lemmas;              // Lemmas walked by the last validation,
+    uint64_t      core_lemmas;               // and those of them that are in the core.
+
+    SolverStats() : gc_runs(0), gc_bytes(0), proof_steps(0), proof_lemmas(0), core_lemmas(0) {
+        for (int p = 0; p < phase_Count; p++) phase_time[p] = 0, phase_calls[p] = 0, phase_depth[p] = 0; }
+
+    void implied  (unsigned part) { if (stats_enabled) count(part_props, part); }
+    void conflict (unsigned part) { if (stats_enabled) count(part_conflicts, part); }
+    void collected(uint64_t bytes){ if (stats_enabled) gc_runs++, gc_bytes += bytes; }
+
+    static double wallTime() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+ private:
+    static void count(vec<uint64_t>& v, unsigned part) {
+        if ((unsigned)v.size() <= part) v.growTo(part + 1, 0);
+        v[part]++; }
+};
+
+
+// Adds the wall time of its scope to a phase:
+class PhaseTimer {
+    SolverStats& s;
+    Phase        p;
+    double       start;
+ public:
+    PhaseTimer(SolverStats& _s, Phase _p) : s(_s), p(_p), start(0) {
+        if (stats_enabled && s.phase_depth[p]++ == 0){
+            s.phase_calls[p]++;
+            start = SolverStats::wallTime(); } }
+    ~PhaseTimer() {
+        if (stats_enabled && --s.phase_depth[p] == 0)
+            s.phase_time[p] += SolverStats::wallTime() - start; }
+};
+
+//=================================================================================================
+}
+
+#endif
@@ -23,6 +23,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_SolverTypes_h
 
 #include <assert.h>
+#include <string.h>
 #include <algorithm>
 
 #include "mtl/IntTypes.h"
@@ -30,6 +31,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "mtl/Vec.h"
 #include "mtl/Map.h"
 #include "mtl/Alloc.h"
+#include "mtl/Scan.h"
+#include "mtl/Sort.h"
+#include "mtl/RefTable.h"
 
 namespace Minisat {
 
@@ -73,6 +77,18 @@ inline  Lit  toLit     (int i)              { Lit p; p.x = i; return p; }
 const Lit lit_Undef = { -2 };  // }- Useful special constants.
 const Lit lit_Error = { -1 };  // }
 
+// Searching arrays of literals (see 'mtl/Scan.h'):
+inline  int  findLit   (const Lit* ps, int n, Lit p)        { return scanEq    ((const uint32_t*)ps, n, (uint32_t)toInt(p)); } // Index of 'p' in 'ps', or 'n'.
+inline  int  findVar   (const Lit* ps, int n, Var v)        { return scanEqShr1((const uint32_t*)ps, n, (uint32_t)v); }        // Index of a literal of 'v' in 'ps', or 'n'.
+inline  bool equalLits (const Lit* ps, const Lit* qs, int n){ return equalWords((const uint32_t*)ps, (const uint32_t*)qs, n); }
+
+// Signature of a set of literals: the signature of a subset has no bit that is not in the signature
+// of the set.
+inline uint64_t litSignature(const Lit* ps, int n) {
+    uint64_t sig = 0;
+    for (int i = 0; i < n; i++) sig |= (uint64_t)1 << (toInt(ps[i]) & 63);
+    return sig; }
+
 
 //=================================================================================================
 // Lifted booleans:
@@ -158,7 +174,16 @@ class Range
 // Clause -- a simple class for representing a clause:
 
 class Clause;
-typedef RegionAllocator<uint32_t>::Ref CRef;
+
+// Clause references are offsets into the clause arena, counted in 32-bit words. With
+// 'MINISAT_WIDE_CREF' they are 64-bit, which lifts the 16 GB limit of the arena (proof logging
+// keeps every lemma alive). Code that includes these headers must agree on the setting.
+#ifdef MINISAT_WIDE_CREF
+typedef RegionAllocator<uint32_t, uint64_t> ClauseRegion;
+#else
+typedef RegionAllocator<uint32_t>           ClauseRegion;
+#endif
+typedef ClauseRegion::Ref CRef;
 
 class Clause {
     struct {
@@ -167,9 +192,11 @@ class Clause {
         unsigned has_extra : 1;
         unsigned reloced   : 1;
         unsigned core      : 1;
-        unsigned size      : 26; }                        header;
+        unsigned spilled   : 1;
+        unsigned size      : 25; }                        header;
     Range                                                 partition;
-    union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
+    union { Lit lit; float act; uint32_t abs;
+            struct { unsigned lbd : 29; unsigned tier : 2; unsigned used : 1; } glue; } data[0];
 
     friend class ClauseAllocator;
 
@@ -181,45 +208,62 @@ class Clause {
         header.has_extra = use_extra;
         header.reloced   = 0;
         header.core = 0;
+        header.spilled   = 0;
         header.size      = ps.size();
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
 
         if (header.has_extra){
-            if (header.learnt)
-                data[header.size].act = 0; 
+            if (header.learnt){
+                data[header.size].act         = 0;
+                data[header.size+1].glue.lbd  = ps.size();
+                data[header.size+1].glue.tier = tier_Local;
+                data[header.size+1].glue.used = 0; }
             else 
                 calcAbstraction(); }
     }
 
 public:
+    // Tiers of the learnt clause database (see 'Solver::reduceDB()'):
+    enum { tier_Core = 0, tier_Two = 1, tier_Local = 2 };
+
+    // The abstraction of a clause without 'learnt' is the signature of its variables, in its two
+    // extra words.
     void calcAbstraction() {
         assert(header.has_extra);
-        uint32_t abstraction = 0;
+        uint64_t abstraction = 0;
         for (int i = 0; i < size(); i++)
-            abstraction |= 1 << (var(data[i].lit) & 31);
-        data[header.size].abs = abstraction;  }
+            abstraction |= (uint64_t)1 << (var(data[i].lit) & 63);
+        data[header.size].abs   = (uint32_t)abstraction;
+        data[header.size+1].abs = (uint32_t)(abstraction >> 32); }
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size()); for (int k = 0; k < extraWords(); k++) data[header.size-i+k] = data[header.size+k]; header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
+    int          extraWords  ()      const   { return header.has_extra ? 2 : 0; }
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
 
     bool         reloced     ()      const   { return header.reloced; }
     void         reloced     (uint32_t r)    { header.reloced = r; }
-    CRef         relocation  ()      const   { return data[0].rel; }
-    void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
+    // The new reference of a relocated clause overwrites its first 'sizeof(CRef)' bytes of data.
+    CRef         relocation  ()      const   { CRef c; memcpy(&c, data, sizeof(CRef)); return c; }
+    void         relocate    (CRef c)        { header.reloced = 1; memcpy(data, &c, sizeof(CRef)); }
 
 
     bool         core        ()      const   { return header.core; }
     void         core        (uint32_t c)    { header.core = c; }
 
+    // A spilled clause is a stub of a deleted proof clause whose literals have been moved to disk
+    // (see 'Solver::pageIn()'). Its only literal is the index of the clause on disk.
+    bool         spilled     ()      const   { return header.spilled; }
+    void         spilled     (uint32_t s)    { header.spilled = s; }
+
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
     Lit&         operator [] (int i)         { return data[i].lit; }
@@ -227,7 +271,16 @@ public:
     operator const Lit* (void) const         { return (Lit*)data; }
 
     float&       activity    ()              { assert(header.has_extra); return data[header.size].act; }
-    uint32_t     abstraction () const        { assert(header.has_extra); return data[header.size].abs; }
+    uint64_t     abstraction () const        { assert(header.has_extra); return data[header.size].abs | (uint64_t)data[header.size+1].abs << 32; }
+
+    // A learnt clause keeps a second extra word: its LBD (the number of decision levels among its
+    // literals when it was last computed), its tier and whether it took part in a conflict lately.
+    unsigned     lbd         ()      const   { assert(header.learnt); return data[header.size+1].glue.lbd; }
+    void         lbd         (unsigned l)    { assert(header.learnt); data[header.size+1].glue.lbd = l; }
+    unsigned     tier        ()      const   { assert(header.learnt); return data[header.size+1].glue.tier; }
+    void         tier        (unsigned t)    { assert(header.learnt); data[header.size+1].glue.tier = t; }
+    bool         used        ()      const   { assert(header.learnt); return data[header.size+1].glue.used; }
+    void         used        (bool u)        { assert(header.learnt); data[header.size+1].glue.used = u; }
 
     Lit          subsumes    (const Clause& other) const;
     void         strengthen  (Lit p);
@@ -242,20 +295,22 @@ public:
 // ClauseAllocator -- a simple class for allocating memory for clauses:
 
 
-const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
-class ClauseAllocator : public RegionAllocator<uint32_t>
+const CRef CRef_Undef = ClauseRegion::Ref_Undef;
+class ClauseAllocator : public ClauseRegion
 {
-    static int clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    static int clauseWord32Size(int size, int extra_words){
+        int data = size + extra_words;
+        if (data * sizeof(Lit) < sizeof(CRef)) data = sizeof(CRef) / sizeof(Lit); // (room for 'relocate()')
+        return (sizeof(Clause) + (sizeof(Lit) * data)) / sizeof(uint32_t); }
  public:
     bool extra_clause_field;
 
-    ClauseAllocator(uint32_t start_cap) : RegionAllocator<uint32_t>(start_cap), extra_clause_field(false){}
+    ClauseAllocator(CRef start_cap) : ClauseRegion(start_cap), extra_clause_field(false){}
     ClauseAllocator() : extra_clause_field(false){}
 
     void moveTo(ClauseAllocator& to){
         to.extra_clause_field = extra_clause_field;
-        RegionAllocator<uint32_t>::moveTo(to); }
+        ClauseRegion::moveTo(to); }
 
     template<class Lits>
     CRef alloc(const Lits& ps, bool learnt = false)
@@ -264,23 +319,23 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
+        CRef cid = ClauseRegion::alloc(clauseWord32Size(ps.size(), use_extra ? 2 : 0));
         new (lea(cid)) Clause(ps, use_extra, learnt);
 
         return cid;
     }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
-    Clause&       operator[](Ref r)       { return (Clause&)RegionAllocator<uint32_t>::operator[](r); }
-    const Clause& operator[](Ref r) const { return (Clause&)RegionAllocator<uint32_t>::operator[](r); }
-    Clause*       lea       (Ref r)       { return (Clause*)RegionAllocator<uint32_t>::lea(r); }
-    const Clause* lea       (Ref r) const { return (Clause*)RegionAllocator<uint32_t>::lea(r); }
-    Ref           ael       (const Clause* t){ return RegionAllocator<uint32_t>::ael((uint32_t*)t); }
+    Clause&       operator[](Ref r)       { return (Clause&)ClauseRegion::operator[](r); }
+    const Clause& operator[](Ref r) const { return (Clause&)ClauseRegion::operator[](r); }
+    Clause*       lea       (Ref r)       { return (Clause*)ClauseRegion::lea(r); }
+    const Clause* lea       (Ref r) const { return (Clause*)ClauseRegion::lea(r); }
+    Ref           ael       (const Clause* t){ return ClauseRegion::ael((uint32_t*)t); }
 
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        ClauseRegion::free(clauseWord32Size(c.size(), c.extraWords()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -296,13 +351,29 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
         to[cr].core(c.core());
+        to[cr].spilled(c.spilled());
         to[cr].part (c.part ());
-        if (to[cr].learnt())         to[cr].activity() = c.activity();
+        if (to[cr].learnt()){
+            to[cr].activity() = c.activity();
+            to[cr].lbd(c.lbd());
+            to[cr].tier(c.tier());
+            to[cr].used(c.used()); }
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
     }
 };
 
 
+// The new reference of a clause that was moved by a garbage collection (see 'RefTable::relocate()'):
+struct ClauseRelocated {
+    const ClauseAllocator& ca;
+    ClauseRelocated(const ClauseAllocator& _ca) : ca(_ca) {}
+    bool operator()(CRef cr, CRef& to) const {
+        if (!ca[cr].reloced()) return false;
+        to = ca[cr].relocation();
+        return true; }
+};
+
+
 //=================================================================================================
 // OccLists -- a class for maintaining occurence lists with lazy deletion:
 
@@ -363,6 +434,170 @@ void OccLists<Idx,Vec,Deleted>::clean(const Idx& idx)
 }
 
 
+//=================================================================================================
+// ArenaLists -- occurrence lists with lazy deletion, kept in a single arena:
+//
+// A list is an offset and a size into one region shared by all lists, or, while it has at most
+// 'Inline' elements, is kept in its header. A list that outgrows its space moves to the end of
+// the region. The space it leaves is reclaimed by 'compact()', which growing a list calls once a
+// quarter of the region is left over. Growing a list may thus move every other list that is not
+// inline: pointers into them are to be refreshed (see 'rebase()').
+
+
+template<class Idx, class T, class Deleted, int Inline = 2>
+class ArenaLists
+{
+    struct Head {
+        union {
+            uint32_t off;       // Offset of the list in 'arena',
+            T        inl[Inline]; // or its elements if it is inline.
+        };
+        int      sz;
+        int      cap;           // At most 'Inline' if the list is inline.
+        Head() : sz(0), cap(Inline) {}
+    };
+
+    struct OffsetLt {
+        const vec<Head>& heads;
+        OffsetLt(const vec<Head>& h) : heads(h) {}
+        bool operator()(int x, int y) const { return heads[x].off < heads[y].off; }
+    };
+
+    RegionAllocator<T> arena;
+    vec<Head>          heads;
+    vec<char>          dirty;
+    vec<Idx>           dirties;
+    Deleted            deleted;
+
+    T*    data      (Head& h)   { return h.cap <= Inline ? h.inl : arena.lea(h.off); }
+    void  grow      (Head& h, int min_cap);
+    void  cleanDirty();
+
+ public:
+    // A list, with the operations of 'vec' that do not depend on where its elements are:
+    class List {
+        ArenaLists* a;
+        Head*       h;
+     public:
+        List(ArenaLists* _a, Head* _h) : a(_a), h(_h) {}
+
+        int      size      () const           { return h->sz; }
+        void     shrink    (int nelems)       { assert(nelems <= h->sz); h->sz -= nelems; }
+        void     pop       ()                 { assert(h->sz > 0); h->sz--; }
+        void     push      (const T& elem)    { if (h->sz == h->cap) a->grow(*h, h->sz + 1); a->data(*h)[h->sz++] = elem; }
+        void     capacity  (int min_cap)      { if (h->cap < min_cap) a->grow(*h, min_cap); }
+        void     clear     (bool dealloc = false) {
+            h->sz = 0;
+            if (dealloc && h->cap > Inline) a->arena.free(h->cap), h->cap = Inline; }
+
+        operator T*        ()                 { return a->data(*h); }
+        T&       operator[](int index)        { return a->data(*h)[index]; }
+        T&       last      ()                 { return a->data(*h)[h->sz - 1]; }
+        void     copyTo    (vec<T>& copy)     { copy.clear(); copy.growTo(h->sz); for (int i = 0; i < h->sz; i++) copy[i] = (*this)[i]; }
+    };
+
+    ArenaLists(const Deleted& d) : arena(1024), deleted(d) {}
+
+    void  init      (const Idx& idx){ heads.growTo(toInt(idx)+1); dirty.growTo(toInt(idx)+1, 0); }
+    List  operator[](const Idx& idx){ return List(this, &heads[toInt(idx)]); }
+    List  lookup    (const Idx& idx){ if (dirty[toInt(idx)]) clean(idx); return (*this)[idx]; }
+
+    void  cleanAll  ()              { if (dirties.size() > 0) cleanDirty(); }
+    void  clean     (const Idx& idx);
+    void  smudge    (const Idx& idx){
+        if (dirty[toInt(idx)] == 0){
+            dirty[toInt(idx)] = 1;
+            dirties.push(idx);
+        }
+    }
+
+    void  compact   ();             // Reclaim the space left by lists that moved.
+
+    void  clear(bool free = true){
+        RegionAllocator<T>(1024).moveTo(arena);
+        heads  .clear(free);
+        dirty  .clear(free);
+        dirties.clear(free);
+    }
+};
+
+
+template<class Idx, class T, class Deleted, int Inline>
+void ArenaLists<Idx,T,Deleted,Inline>::grow(Head& h, int min_cap)
+{
+    // -- many lists moved since the last compaction, reclaim their space rather than grow the region
+    if (arena.wasted() > arena.size() / 4) compact();
+
+    // -- grow by about 3/2 like 'vec', in place if the list ends the region
+    int add = std::max((min_cap - h.cap + 1) & ~1, ((h.cap >> 1) + 2) & ~1);
+    if (h.cap > Inline && h.off + h.cap == arena.size()){
+        arena.alloc(add);
+        h.cap += add;
+        return; }
+
+    uint32_t off = arena.alloc(h.cap + add);
+    memcpy(arena.lea(off), data(h), sizeof(T) * h.sz);
+    if (h.cap > Inline) arena.free(h.cap);
+    h.off  = off;
+    h.cap += add;
+}
+
+
+template<class Idx, class T, class Deleted, int Inline>
+void ArenaLists<Idx,T,Deleted,Inline>::compact()
+{
+    // -- slide the lists down in the order of their offsets, so that no second region is needed
+    vec<int> order;
+    for (int i = 0; i < heads.size(); i++)
+        if (heads[i].cap > Inline) order.push(i);
+    sort(order, OffsetLt(heads));
+
+    // -- the capacities are kept, a list that is short now is likely to grow again
+    uint32_t end = 0;
+    for (int k = 0; k < order.size(); k++){
+        Head& h = heads[order[k]];
+        memmove(arena.lea(end), arena.lea(h.off), sizeof(T) * h.sz);
+        h.off = end;
+        end  += h.cap;
+    }
+    arena.truncate(end);
+}
+
+
+template<class Idx, class T, class Deleted, int Inline>
+void ArenaLists<Idx,T,Deleted,Inline>::cleanDirty()
+{
+    for (int i = 0; i < dirties.size(); i++)
+        // Dirties may contain duplicates so check here if a variable is already cleaned:
+        if (dirty[toInt(dirties[i])])
+            clean(dirties[i]);
+    dirties.clear();
+}
+
+
+template<class Idx, class T, class Deleted, int Inline>
+void ArenaLists<Idx,T,Deleted,Inline>::clean(const Idx& idx)
+{
+    Head& h  = heads[toInt(idx)];
+    T*    ts = data(h);
+    int   i, j;
+    for (i = j = 0; i < h.sz; i++)
+        if (!deleted(ts[i]))
+            ts[j++] = ts[i];
+    h.sz = j;
+    dirty[toInt(idx)] = 0;
+}
+
+
+// Moves the pointers 'i', 'j' and 'end' into a list whose elements moved from 'from' to 'to':
+template<class T>
+static inline void rebase(T*& from, T* to, T*& i, T*& j, T*& end)
+{
+    i = to + (i - from); j = to + (j - from); end = to + (end - from);
+    from = to;
+}
+
+
 //=================================================================================================
 // CMap -- a class for mapping clauses to values:
 
@@ -371,7 +606,7 @@ template<class T>
 class CMap
 {
     struct CRefHash {
-        uint32_t operator()(CRef cr) const { return (uint32_t)cr; } };
+        uint32_t operator()(CRef cr) const { return (uint32_t)cr ^ (uint32_t)((uint64_t)cr >> 32); } };
 
     typedef Map<CRef, T, CRefHash> HashTable;
     HashTable map;
@@ -424,26 +659,21 @@ inline Lit Clause::subsumes(const Clause& other) const
     //if (other.size() < size() || (!learnt() && !other.learnt() && (extra.abst & ~other.extra.abst) != 0))
     assert(!header.learnt);   assert(!other.header.learnt);
     assert(header.has_extra); assert(other.header.has_extra);
-    if (other.header.size < header.size || (data[header.size].abs & ~other.data[other.header.size].abs) != 0)
+    if (other.header.size < header.size || (abstraction() & ~other.abstraction()) != 0)
         return lit_Error;
 
     Lit        ret = lit_Undef;
     const Lit* c   = (const Lit*)(*this);
     const Lit* d   = (const Lit*)other;
+    int        n   = other.header.size;
 
     for (unsigned i = 0; i < header.size; i++) {
-        // search for c[i] or ~c[i]
-        for (unsigned j = 0; j < other.header.size; j++)
-            if (c[i] == d[j])
-                goto ok;
-            else if (ret == lit_Undef && c[i] == ~d[j]){
-                ret = c[i];
-                goto ok;
-            }
-
-        // did not find it
-        return lit_Error;
-    ok:;
+        // search for c[i], or for ~c[i] before it
+        int j = findLit(d, n, c[i]);
+        if (ret == lit_Undef && findLit(d, j, ~c[i]) < j)
+            ret = c[i];
+        else if (j == n)
+            return lit_Error;
     }
 
     return ret;
@@ -0,0 +1,59 @@
+#ifndef Minisat_StateFile_h
+#define Minisat_StateFile_h
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// StateFile -- the sections of a solver snapshot (see 'Solver::saveState()'):
+//
+// A value is stored as its bytes, a vector as its size followed by the bytes of its elements. The
+// sections are written to a file and read back from a mapping of it. Once a write or read fails,
+// 'ok' is cleared and all further operations do nothing.
+
+
+struct StateFile {
+    FILE*       out;
+    const char* in;
+    const char* end;
+    bool        ok;
+
+    explicit StateFile(FILE* f)              : out(f),    in(NULL), end(NULL), ok(true) {}
+    StateFile(const char* b, const char* e)  : out(NULL), in(b),    end(e),    ok(true) {}
+
+    template<class T>
+    void put(const T& x) {
+        if (ok && fwrite(&x, sizeof(T), 1, out) != 1) ok = false; }
+
+    template<class T>
+    void put(const vec<T>& v) {
+        put(v.size());
+        if (ok && v.size() > 0 && fwrite(&v[0], sizeof(T), v.size(), out) != (size_t)v.size()) ok = false; }
+
+    template<class T>
+    void get(T& x) {
+        if (ok && (size_t)(end - in) < sizeof(T)) ok = false;
+        if (!ok) return;
+        memcpy(&x, in, sizeof(T));
+        in += sizeof(T); }
+
+    template<class T>
+    void get(vec<T>& v) {
+        int n = 0;
+        get(n);
+        if (ok && (n < 0 || (size_t)(end - in) / sizeof(T) < (size_t)n)) ok = false;
+        if (!ok) return;
+        v.clear();
+        v.growTo(n);
+        if (n > 0) memcpy(&v[0], in, sizeof(T) * n);
+        in += sizeof(T) * n; }
+};
+
+//=================================================================================================
+}
+
+#endif
@@ -2,155 +2,128 @@
 
 namespace Minisat
 {
-  namespace
-  {
-    void toDimacs (FILE* out, Lit lit)
-    {
-      fprintf (out, "%s%d", sign (lit) ? "-" : "", var (lit) + 1);
-    }
-    
-    void toDimacs (FILE* out, const Clause &c)
-    {
-      for (int i = 0; i < c.size (); ++i)
-      {
-        toDimacs (out, c[i]);
-        fprintf (out, " ");
-      }
-    }
-    
-  }
-    
-  TraceProofVisitor::TraceProofVisitor (Solver &solver, FILE* out) 
-    : m_Solver (solver), m_ids(1), m_out (out) 
+  TraceProofVisitor::TraceProofVisitor (Solver &solver, FILE* out)
+    : m_Solver (solver), m_ids(1), m_own (new TraceWriter (out)), m_out (*m_own)
+   {
+     m_units.growTo (m_Solver.nVars (), -1);
+   }
+
+  TraceProofVisitor::TraceProofVisitor (Solver &solver, TraceWriter &out)
+    : m_Solver (solver), m_ids(1), m_own (NULL), m_out (out)
    {
      m_units.growTo (m_Solver.nVars (), -1);
    }
- 
-  int TraceProofVisitor::visitResolvent (Lit parent, Lit p1, CRef p2)
+
+  TraceProofVisitor::~TraceProofVisitor ()
   {
-    if (m_units [var (p1)] < 0)
-    {
-      m_units [var (p1)] = m_ids++;
-      fprintf (m_out, "%d ", m_ids - 1);
-      toDimacs (m_out, p1);
-      fprintf (m_out, " 0 0\n");
-    }
-    int id;
-    if (!m_visited.has (p2, id))
-    {
-      m_visited.insert (p2, m_ids++);
-      fprintf (m_out, "%d ", m_ids - 1);
-      toDimacs (m_out, m_Solver.getClause (p2));
-      fprintf (m_out, " 0 0\n");
-    }
-    
-    m_units [var (parent)] = m_ids++;
-    
-    fprintf (m_out, "%d ", m_ids - 1);
-    toDimacs (m_out, parent);
-    fprintf (m_out, " 0 ");
-    
-    id = -1;
-    m_visited.has (p2, id);
-    fprintf (m_out, "%d %d 0\n", m_units [var (p1)], id);
-    
-    return 0;
+    if (m_own != NULL) delete m_own;
+    else m_out.flush ();
   }
 
-  int TraceProofVisitor::visitChainResolvent (Lit parent)
+  /// -- writes the unit 'p' as a leaf unless it has an id already
+  void TraceProofVisitor::writeUnit (Lit p)
   {
-    doAntecendents ();
-    Var vp = var (parent);
-    
+    Var vp = var (p);
+    if (m_units [vp] >= 0) return;
+
     m_units [vp] = m_ids++;
-    fprintf (m_out, "%d ", m_ids-1);
-    toDimacs (m_out, parent);
-    fprintf (m_out, " 0 ");
+    m_out.beginStep (m_units [vp]);
+    m_out.lit (p);
+    m_out.endLits ();
+    m_out.endStep ();
+  }
+
+  void TraceProofVisitor::writeLeaf (int id, const Clause &c)
+  {
+    m_out.beginStep (id);
+    for (int i = 0; i < c.size (); ++i) m_out.lit (c [i]);
+    m_out.endLits ();
+    m_out.endStep ();
+  }
 
-    int id;
-    m_visited.has (chainClauses [0], id);
-    fprintf (m_out, "%d ", id);
-    for (int i = 0; i < chainPivots.size (); ++i)
+  /// -- writes the antecedents of the step and ends it
+  void TraceProofVisitor::writeChain (const ProofStep &s)
+  {
+    m_out.antecedent (clauseId (s.clauses [0]));
+    for (int i = 0; i < s.nPivots; ++i)
     {
-      if (i+1 < chainClauses.size () && chainClauses [i+1] != CRef_Undef)
-      {
-        m_visited.has (chainClauses [i+1], id);
-        fprintf (m_out, "%d ", id);
-      }
+      if (i+1 < s.nClauses && s.clauses [i+1] != CRef_Undef)
+        m_out.antecedent (clauseId (s.clauses [i+1]));
       else
-        fprintf (m_out, "%d ", m_units [var (chainPivots [i])]);
+        m_out.antecedent (m_units [var (s.pivots [i])]);
     }
-    fprintf (m_out, " 0\n");
-
-    return 0;
+    m_out.endStep ();
   }
 
-  void TraceProofVisitor::doAntecendents ()
-  {   
-    int id;
-    if (!m_visited.has (chainClauses [0], id))
-    {
-      m_visited.insert (chainClauses [0], m_ids++);
-      fprintf (m_out, "%d ", m_ids-1);
-      toDimacs (m_out, m_Solver.getClause (chainClauses [0]));
-      fprintf (m_out, " 0 0\n");
-    }
-    
-    for (int i = 0; i < chainPivots.size (); ++i)
+  void TraceProofVisitor::doAntecendents (const ProofStep &s)
+  {
+    if (clauseId (s.clauses [0]) == 0)
+      writeLeaf (newClauseId (s.clauses [0]), m_Solver.getClause (s.clauses [0]));
+
+    for (int i = 0; i < s.nPivots; ++i)
     {
-      if (i + 1 < chainClauses.size () && chainClauses[i+1] != CRef_Undef)
+      if (i + 1 < s.nClauses && s.clauses [i+1] != CRef_Undef)
       {
-        if (!m_visited.has (chainClauses [i+1], id))
-        {
-          m_visited.insert (chainClauses [i+1], m_ids++);
-          fprintf (m_out, "%d ", m_ids-1);
-          toDimacs (m_out, m_Solver.getClause (chainClauses [i+1]));
-          fprintf (m_out, " 0 0\n");
-        }
+        if (clauseId (s.clauses [i+1]) == 0)
+          writeLeaf (newClauseId (s.clauses [i+1]), m_Solver.getClause (s.clauses [i+1]));
       }
       else
-      {
-        Var vp = var (chainPivots [i]);
-        if (m_units [vp] < 0)
-        {
-          m_units [vp] = m_ids++;
-          fprintf (m_out, "%d ", m_ids-1);
-          toDimacs (m_out, chainPivots [i]);
-          fprintf (m_out, " 0 0\n");
-        }
-      }
+        writeUnit (s.pivots [i]);
     }
   }
-  
-  int TraceProofVisitor::visitChainResolvent (CRef parent)
+
+  int TraceProofVisitor::visitStep (const ProofStep &s)
   {
-    doAntecendents ();
-    
-    if (parent != CRef_Undef)
-      m_visited.insert (parent, m_ids++);
-    else m_ids++;
-    
-    fprintf (m_out, "%d ", m_ids-1);
-    if (parent != CRef_Undef) toDimacs (m_out, m_Solver.getClause (parent));
-    fprintf (m_out, " 0 ");
-    
-    int id;
-    m_visited.has (chainClauses [0], id);
-    fprintf (m_out, "%d ", id);
-    for (int i = 0; i < chainPivots.size (); ++i)
+    if (s.kind == ProofStep::Resolvent)
     {
-      if (i+1 < chainClauses.size () && chainClauses[i+1] != CRef_Undef)
+      Lit p1 = s.pivots [0];
+      CRef p2 = s.clauses [0];
+      writeUnit (p1);
+      int id = clauseId (p2);
+      if (id == 0)
       {
-        m_visited.has (chainClauses [i+1], id);
-        fprintf (m_out, "%d ", id);
+        id = newClauseId (p2);
+        writeLeaf (id, m_Solver.getClause (p2));
       }
-      else
-        fprintf (m_out, "%d ", m_units [var (chainPivots [i])]);
+
+      m_units [var (s.lit)] = m_ids++;
+      m_out.beginStep (m_units [var (s.lit)]);
+      m_out.lit (s.lit);
+      m_out.endLits ();
+      m_out.antecedent (m_units [var (p1)]);
+      m_out.antecedent (id);
+      m_out.endStep ();
+      return 0;
     }
-    fprintf (m_out, " 0\n");
-    return 0;
-  }
-}
 
+    doAntecendents (s);
+
+    if (s.kind == ProofStep::ChainLit)
+    {
+      Var vp = var (s.lit);
+      m_units [vp] = m_ids++;
+      m_out.beginStep (m_units [vp]);
+      m_out.lit (s.lit);
+      m_out.endLits ();
+      writeChain (s);
+      return 0;
+    }
 
+    // -- a clause that was written before keeps its first id
+    int id = m_ids;
+    if (s.clause != CRef_Undef && clauseId (s.clause) == 0) newClauseId (s.clause);
+    else m_ids++;
 
+    m_out.beginStep (id);
+    if (s.clause != CRef_Undef)
+    {
+      const Clause &c = m_Solver.getClause (s.clause);
+      for (int i = 0; i < c.size (); ++i) m_out.lit (c [i]);
+    }
+    m_out.endLits ();
+    writeChain (s);
+    // -- the empty clause ends the proof
+    if (s.clause == CRef_Undef) m_out.flush ();
+    return 0;
+  }
+}
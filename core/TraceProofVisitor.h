@@ -3,29 +3,43 @@
 
 #include "ProofVisitor.h"
 #include "Solver.h"
+#include "TraceWriter.h"
 
 #include <cstdio>
 
 namespace Minisat
 {
- class TraceProofVisitor : public ProofVisitor
+ class TraceProofVisitor : public StaticProofVisitor<TraceProofVisitor>
  {
  protected:
    Solver &m_Solver;
-   CMap<int> m_visited;
+   /// -- trace id of each clause, 0 if not written yet
+   RefTable<CRef, int> m_visited;
 
    vec<int> m_units;
    int m_ids;
-   FILE *m_out;
-   
-   void doAntecendents ();
-   
+   TraceWriter *m_own;
+   TraceWriter &m_out;
+
+   int clauseId (CRef cr)
+   { return m_visited [cr]; }
+   int newClauseId (CRef cr)
+   {
+     m_visited.insert (cr, m_ids);
+     return m_ids++;
+   }
+
+   void writeUnit (Lit p);
+   void writeLeaf (int id, const Clause &c);
+   void writeChain (const ProofStep &s);
+   void doAntecendents (const ProofStep &s);
+
  public:
    TraceProofVisitor (Solver &solver, FILE* out);
-   
-   int visitResolvent (Lit parent, Lit p1, CRef p2);
-   int visitChainResolvent (Lit parent);
-   int visitChainResolvent (CRef parent);
+   TraceProofVisitor (Solver &solver, TraceWriter &out);
+   ~TraceProofVisitor ();
+
+   int visitStep (const ProofStep &s);
  };
 }
 #endif
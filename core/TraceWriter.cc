@@ -0,0 +1,62 @@
+#include "TraceWriter.h"
+
+#include <cstdlib>
+
+namespace Minisat
+{
+  TraceWriter::TraceWriter (FILE* out, bool binary)
+    : m_file (out), m_gz (NULL), m_binary (binary), m_size (0)
+  {
+    m_buf = (char*) malloc (Capacity);
+    if (m_buf == NULL) throw OutOfMemoryException ();
+  }
+
+  TraceWriter::TraceWriter (gzFile out, bool binary)
+    : m_file (NULL), m_gz (out), m_binary (binary), m_size (0)
+  {
+    m_buf = (char*) malloc (Capacity);
+    if (m_buf == NULL) throw OutOfMemoryException ();
+  }
+
+  TraceWriter::~TraceWriter ()
+  {
+    flush ();
+    free (m_buf);
+  }
+
+  void TraceWriter::flush ()
+  {
+    if (m_size == 0) return;
+    if (m_gz != NULL) gzwrite (m_gz, m_buf, m_size);
+    else fwrite (m_buf, 1, m_size, m_file);
+    m_size = 0;
+  }
+
+  void TraceWriter::number (int x)
+  {
+    if (!m_binary) { text (x); return; }
+
+    // -- at most 5 bytes of 7 bits for a 32 bit number
+    reserve (5);
+    unsigned u = 2 * (unsigned) (x < 0 ? -x : x) + (x < 0);
+    while (u > 0x7f)
+    {
+      m_buf [m_size++] = (char) (0x80 | (u & 0x7f));
+      u >>= 7;
+    }
+    m_buf [m_size++] = (char) u;
+  }
+
+  void TraceWriter::text (int x)
+  {
+    // -- a sign, 10 digits and a space
+    reserve (12);
+    if (x < 0) { m_buf [m_size++] = '-'; x = -x; }
+
+    char digits [10];
+    int n = 0;
+    do { digits [n++] = (char) ('0' + x % 10); x /= 10; } while (x > 0);
+    while (n > 0) m_buf [m_size++] = digits [--n];
+    m_buf [m_size++] = ' ';
+  }
+}
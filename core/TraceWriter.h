@@ -0,0 +1,53 @@
+#ifndef _TRACE_WRITER_H_
+#define _TRACE_WRITER_H_
+
+#include "SolverTypes.h"
+
+#include <cstdio>
+#include <zlib.h>
+
+namespace Minisat
+{
+  /// Buffered writer of TraceCheck steps.
+  ///
+  /// A step is written as 'beginStep (id)', 'lit ()' for each literal,
+  /// 'endLits ()', 'antecedent ()' for each antecedent and 'endStep ()'.
+  /// In text mode a step is the TraceCheck line "id lits 0 antecedents 0".
+  /// In binary mode it is encoded like an addition step of binary LRAT:
+  /// the byte 'a', followed by the id, the literals, 0, the antecedents
+  /// and 0, each number 'x' written as the variable length encoding of
+  /// '2*|x| + (x < 0)'. The output is optionally gzip compressed.
+  class TraceWriter
+  {
+  protected:
+    FILE *m_file;
+    gzFile m_gz;
+    bool m_binary;
+    char *m_buf;
+    int m_size;
+
+    enum { Capacity = 1 << 20 };
+
+    void reserve (int n) { if (m_size + n > Capacity) flush (); }
+    void number (int x);
+    void text (int x);
+
+  public:
+    TraceWriter (FILE* out, bool binary = false);
+    TraceWriter (gzFile out, bool binary = false);
+    ~TraceWriter ();
+
+    void beginStep (int id) { if (m_binary) { reserve (1); m_buf [m_size++] = 'a'; } number (id); }
+    void lit (Lit p) { number (sign (p) ? -(var (p) + 1) : var (p) + 1); }
+    void endLits () { number (0); }
+    void antecedent (int id) { number (id); }
+    void endStep ()
+    {
+      number (0);
+      if (!m_binary) m_buf [m_size - 1] = '\n';
+    }
+
+    void flush ();
+  };
+}
+#endif
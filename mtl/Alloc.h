@@ -21,6 +21,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Alloc_h
 #define Minisat_Alloc_h
 
+#include <string.h>
+
+#include "mtl/IntTypes.h"
 #include "mtl/XAlloc.h"
 #include "mtl/Vec.h"
 
@@ -28,36 +31,51 @@ namespace Minisat {
 
 //=================================================================================================
 // Simple Region-based memory allocator:
+//
+// 'R' is the unsigned type of references (and sizes) into the region, it bounds the region to
+// 'max(R)' units of 'T'. Regions of at least 'xmap_threshold' bytes are mapped directly, so that
+// growing them remaps their pages instead of copying them.
 
-template<class T>
+template<class T, class R = uint32_t>
 class RegionAllocator
 {
     T*        memory;
-    uint32_t  sz;
-    uint32_t  cap;
-    uint32_t  wasted_;
+    R         sz;
+    R         cap;
+    R         wasted_;
+    bool      mapped;   // 'memory' comes from 'xmremap()' rather than 'xrealloc()'.
+    bool      view;     // 'memory' is a private mapping of a file (see 'adopt()').
 
-    void capacity(uint32_t min_cap);
+    void capacity(R min_cap);
+    void release();
 
  public:
     // TODO: make this a class for better type-checking?
-    typedef uint32_t Ref;
-    enum { Ref_Undef = UINT32_MAX };
+    typedef R Ref;
+    static const Ref Ref_Undef = (Ref)~(Ref)0;
     enum { Unit_Size = sizeof(uint32_t) };
 
-    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
-    ~RegionAllocator()
-    {
-        if (memory != NULL)
-            ::free(memory);
-    }
+    explicit RegionAllocator(Ref start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0), mapped(false), view(false){ capacity(start_cap); }
+    ~RegionAllocator() { release(); }
 
 
-    uint32_t size      () const      { return sz; }
-    uint32_t wasted    () const      { return wasted_; }
+    Ref      size      () const      { return sz; }
+    Ref      wasted    () const      { return wasted_; }
 
     Ref      alloc     (int size); 
     void     free      (int size)    { wasted_ += size; }
+    void     reserve   (Ref min_cap) { capacity(min_cap); }
+
+    // Drop the units from 'size' on, after the region was compacted in place (nothing is wasted then):
+    void     truncate  (Ref size)    { assert(size <= sz); sz = size; wasted_ = 0; }
+
+    // Take over 'mem', a private mapping of a file holding a region of 'size' units with room for
+    // 'room'. Pages are copied when they are first written, and all of them once the region
+    // outgrows the mapping:
+    void     adopt     (T* mem, Ref size, Ref room, Ref wasted) {
+        release();
+        memory = mem; sz = size; cap = room; wasted_ = wasted;
+        mapped = view = true; }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     T&       operator[](Ref r)       { assert(r >= 0 && r < sz); return memory[r]; }
@@ -69,31 +87,45 @@ class RegionAllocator
         return  (Ref)(t - &memory[0]); }
 
     void     moveTo(RegionAllocator& to) {
-        if (to.memory != NULL) ::free(to.memory);
+        to.release();
         to.memory = memory;
         to.sz = sz;
         to.cap = cap;
         to.wasted_ = wasted_;
+        to.mapped = mapped;
+        to.view = view;
 
         memory = NULL;
         sz = cap = wasted_ = 0;
+        mapped = view = false;
     }
 
 
 };
 
-template<class T>
-void RegionAllocator<T>::capacity(uint32_t min_cap)
+template<class T, class R>
+const typename RegionAllocator<T,R>::Ref RegionAllocator<T,R>::Ref_Undef;
+
+template<class T, class R>
+void RegionAllocator<T,R>::release()
+{
+    if (memory == NULL) return;
+    if (mapped) xunmap(memory, sizeof(T)*(size_t)cap);
+    else        ::free(memory);
+}
+
+template<class T, class R>
+void RegionAllocator<T,R>::capacity(R min_cap)
 {
     if (cap >= min_cap) return;
 
-    uint32_t prev_cap = cap;
+    R prev_cap = cap;
     while (cap < min_cap){
         // NOTE: Multiply by a factor (13/8) without causing overflow, then add 2 and make the
         // result even by clearing the least significant bit. The resulting sequence of capacities
-        // is carefully chosen to hit a maximum capacity that is close to the '2^32-1' limit when
-        // using 'uint32_t' as indices so that as much as possible of this space can be used.
-        uint32_t delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+        // is carefully chosen to hit a maximum capacity that is close to the 'max(R)' limit so
+        // that as much as possible of this space can be used.
+        R delta = ((cap >> 1) + (cap >> 3) + 2) & ~(R)1;
         cap += delta;
 
         if (cap <= prev_cap)
@@ -102,19 +134,37 @@ void RegionAllocator<T>::capacity(uint32_t min_cap)
     // printf(" .. (%p) cap = %u\n", this, cap);
 
     assert(cap > 0);
-    memory = (T*)xrealloc(memory, sizeof(T)*cap);
+    size_t bytes = sizeof(T)*(size_t)cap;
+    if (view){
+        // Growing the mapping of a file would reach past its end: copy the region instead.
+        T* mem = (T*)xmremap(NULL, 0, bytes);
+        memcpy(mem, memory, sizeof(T)*(size_t)sz);
+        xunmap(memory, sizeof(T)*(size_t)prev_cap);
+        memory = mem;
+        view   = false;
+    }else if (mapped)
+        memory = (T*)xmremap(memory, sizeof(T)*(size_t)prev_cap, bytes);
+    else if (bytes >= xmap_threshold){
+        // The region becomes large: move it once from the heap to a mapping of its own.
+        T* mem = (T*)xmremap(NULL, 0, bytes);
+        if (memory != NULL) memcpy(mem, memory, sizeof(T)*(size_t)sz);
+        ::free(memory);
+        memory = mem;
+        mapped = true;
+    }else
+        memory = (T*)xrealloc(memory, bytes);
 }
 
 
-template<class T>
-typename RegionAllocator<T>::Ref
-RegionAllocator<T>::alloc(int size)
+template<class T, class R>
+typename RegionAllocator<T,R>::Ref
+RegionAllocator<T,R>::alloc(int size)
 { 
     // printf("ALLOC called (this = %p, size = %d)\n", this, size); fflush(stdout);
     assert(size > 0);
     capacity(sz + size);
 
-    uint32_t prev_sz = sz;
+    R prev_sz = sz;
     sz += size;
     
     // Handle overflow:
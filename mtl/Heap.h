@@ -27,18 +27,20 @@ namespace Minisat {
 
 //=================================================================================================
 // A heap implementation with support for decrease/increase key.
+//
+// Every node has 'Arity' children. A 4-ary heap is half as deep as a binary one, which makes
+// 'decrease()' cheaper, and the children that 'percolateDown()' compares are adjacent in memory.
 
 
-template<class Comp>
+template<class Comp, int Arity = 2>
 class Heap {
     Comp     lt;       // The heap is a minimum-heap with respect to this comparator
     vec<int> heap;     // Heap of integers
     vec<int> indices;  // Each integers position (index) in the Heap
 
     // Index "traversal" functions
-    static inline int left  (int i) { return i*2+1; }
-    static inline int right (int i) { return (i+1)*2; }
-    static inline int parent(int i) { return (i-1) >> 1; }
+    static inline int child (int i) { return i*Arity+1; }   // (the first one)
+    static inline int parent(int i) { return (i-1) / Arity; }
 
 
     void percolateUp(int i)
@@ -60,12 +62,16 @@ class Heap {
     void percolateDown(int i)
     {
         int x = heap[i];
-        while (left(i) < heap.size()){
-            int child = right(i) < heap.size() && lt(heap[right(i)], heap[left(i)]) ? right(i) : left(i);
-            if (!lt(heap[child], x)) break;
-            heap[i]          = heap[child];
+        while (child(i) < heap.size()){
+            int first = child(i);
+            int last  = first + Arity < heap.size() ? first + Arity : heap.size();
+            int c     = first;
+            for (int k = first + 1; k < last; k++)
+                if (lt(heap[k], heap[c])) c = k;
+            if (!lt(heap[c], x)) break;
+            heap[i]          = heap[c];
             indices[heap[i]] = i;
-            i                = child;
+            i                = c;
         }
         heap   [i] = x;
         indices[x] = i;
@@ -126,6 +132,7 @@ class Heap {
         heap.clear();
 
         for (int i = 0; i < ns.size(); i++){
+            indices.growTo(ns[i]+1, -1);
             indices[ns[i]] = i;
             heap.push(ns[i]); }
 
@@ -0,0 +1,71 @@
+#ifndef Minisat_RefTable_h
+#define Minisat_RefTable_h
+
+#include "mtl/IntTypes.h"
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// RefTable -- values for references into a region, kept in a table indexed by the reference:
+//
+// A lookup is a bounds check and a load, without hashing. The table grows to the largest
+// reference that was given a value, so it suits references into a compact region such as the
+// clause arena. A reference without a value maps to 'undef'. Once the region was compacted,
+// 'relocate()' moves the values to the new references.
+
+
+template<class R, class T>
+class RefTable
+{
+    vec<T> table;
+    T      undef;
+    int    n;                   // Number of references with a value.
+
+ public:
+    explicit RefTable(const T& u = T()) : undef(u), n(0) {}
+
+    int      size    ()                const { return n; }
+
+    bool     has     (R r)             const { return r < (R)table.size() && table[r] != undef; }
+    bool     has     (R r, T& t)       const { if (!has(r)) return false; t = table[r]; return true; }
+    const T& operator[](R r)           const { return r < (R)table.size() ? table[r] : undef; }
+
+    void     insert  (R r, const T& t) {
+        assert(t != undef);
+        if (r >= (R)table.size()) table.growTo((int)r + 1, undef);
+        if (table[r] == undef) n++;
+        table[r] = t; }
+    void     remove  (R r)             { if (has(r)) table[r] = undef, n--; }
+    void     clear   (bool dealloc = false) { table.clear(dealloc); n = 0; }
+
+    void     moveTo  (RefTable& other) { table.moveTo(other.table); other.undef = undef; other.n = n; n = 0; }
+
+    // Move the values to the new references: 'reloc(r, to)' sets 'to' to the new reference of 'r',
+    // or returns false to drop the value of 'r':
+    template<class Reloc>
+    void     relocate(const Reloc& reloc);
+};
+
+
+template<class R, class T>
+template<class Reloc>
+void RefTable<R,T>::relocate(const Reloc& reloc)
+{
+    vec<T> to;
+    for (int i = 0; i < table.size(); i++){
+        R r;
+        if (table[i] == undef) continue;
+        if (!reloc((R)i, r)){
+            n--;
+            continue; }
+        if (r >= (R)to.size()) to.growTo((int)r + 1, undef);
+        to[r] = table[i];
+    }
+    to.moveTo(table);
+}
+
+//=================================================================================================
+}
+
+#endif
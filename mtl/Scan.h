@@ -0,0 +1,92 @@
+#ifndef Minisat_Scan_h
+#define Minisat_Scan_h
+
+#include "mtl/IntTypes.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Minisat {
+
+//=================================================================================================
+// Searching arrays of 32-bit words:
+//
+// The loops compare 8 words at a time with AVX2 and 4 words with SSE2, if the compiler targets
+// them (see MINISAT_NATIVE), and finish with a plain loop. The results do not depend on which
+// of them is used.
+
+
+// Index of the first 'a[i] == x', or 'n' if there is none.
+static inline int scanEq(const uint32_t* a, int n, uint32_t x)
+{
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256i k8 = _mm256_set1_epi32((int)x);
+    for (; i + 8 <= n; i += 8){
+        __m256i w = _mm256_loadu_si256((const __m256i*)(a + i));
+        int     m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(w, k8)));
+        if (m != 0) return i + __builtin_ctz(m); }
+#endif
+#if defined(__SSE2__)
+    const __m128i k4 = _mm_set1_epi32((int)x);
+    for (; i + 4 <= n; i += 4){
+        __m128i w = _mm_loadu_si128((const __m128i*)(a + i));
+        int     m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(w, k4)));
+        if (m != 0) return i + __builtin_ctz(m); }
+#endif
+    for (; i < n; i++)
+        if (a[i] == x) return i;
+    return n;
+}
+
+
+// Index of the first 'a[i] >> 1 == x', or 'n' if there is none.
+static inline int scanEqShr1(const uint32_t* a, int n, uint32_t x)
+{
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256i k8 = _mm256_set1_epi32((int)x);
+    for (; i + 8 <= n; i += 8){
+        __m256i w = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i*)(a + i)), 1);
+        int     m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(w, k8)));
+        if (m != 0) return i + __builtin_ctz(m); }
+#endif
+#if defined(__SSE2__)
+    const __m128i k4 = _mm_set1_epi32((int)x);
+    for (; i + 4 <= n; i += 4){
+        __m128i w = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(a + i)), 1);
+        int     m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(w, k4)));
+        if (m != 0) return i + __builtin_ctz(m); }
+#endif
+    for (; i < n; i++)
+        if (a[i] >> 1 == x) return i;
+    return n;
+}
+
+
+// Whether 'a[0..n)' and 'b[0..n)' are the same words.
+static inline bool equalWords(const uint32_t* a, const uint32_t* b, int n)
+{
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8){
+        __m256i d = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        if (!_mm256_testz_si256(d, d)) return false; }
+#endif
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4){
+        __m128i e = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        if (_mm_movemask_epi8(e) != 0xFFFF) return false; }
+#endif
+    for (; i < n; i++)
+        if (a[i] != b[i]) return false;
+    return true;
+}
+
+//=================================================================================================
+}
+
+#endif
@@ -58,6 +58,7 @@ public:
 
     // Pointer to first element:
     operator T*       (void)           { return data; }
+    operator const T* (void) const     { return data; }
 
     // Size operations:
     int      size     (void) const     { return sz; }
@@ -24,6 +24,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <errno.h>
 #include <stdlib.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 namespace Minisat {
 
 //=================================================================================================
@@ -39,6 +43,39 @@ static inline void* xrealloc(void *ptr, size_t size)
         return mem;
 }
 
+//=================================================================================================
+// Large blocks with their own mapping. Growing such a block with 'xmremap()' moves its pages
+// instead of copying them. Elsewhere than on Linux, the heap is used instead:
+
+static const size_t xmap_threshold = (size_t)64 << 20;
+
+static inline void* xmremap(void *ptr, size_t old_size, size_t size)
+{
+#ifdef __linux__
+    void* mem = ptr == NULL ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+                            : mremap(ptr, old_size, size, MREMAP_MAYMOVE);
+    if (mem == MAP_FAILED)
+        throw OutOfMemoryException();
+#ifdef MADV_HUGEPAGE
+    madvise(mem, size, MADV_HUGEPAGE);
+#endif
+    return mem;
+#else
+    (void)old_size;
+    return xrealloc(ptr, size);
+#endif
+}
+
+static inline void xunmap(void *ptr, size_t size)
+{
+#ifdef __linux__
+    munmap(ptr, size);
+#else
+    (void)size;
+    free(ptr);
+#endif
+}
+
 //=================================================================================================
 }
 
@@ -69,6 +69,65 @@ static void SIGINT_exit(int signum) {
     _exit(1); }
 
 
+//=================================================================================================
+// Writes the statistics as one JSON object, for monitoring (the phase and partition figures are
+// only recorded if built with MINISAT_STATS):
+
+static void writeStatsJSON(Solver& S, const char* file, const char* status)
+{
+    FILE* out = fopen(file, "w");
+    if (out == NULL){ fprintf(stderr, "ERROR! Could not open file: %s\n", file); return; }
+
+    const SolverStats& st = S.stats();
+    double mem_used = 0.0;
+#if defined(__linux__)
+    mem_used = memUsedPeak();
+#endif
+    fprintf(out, "{\"status\":\"%s\",\"instrumented\":%s,\"cpu_time\":%g,\"mem_used_mb\":%g,"
+                 "\"vars\":%d,\"clauses\":%d,\"learnts\":%d,",
+            status, stats_enabled ? "true" : "false", cpuTime(), mem_used, S.nVars(), S.nClauses(), S.nLearnts());
+    fprintf(out, "\"restarts\":%" PRIu64 ",\"conflicts\":%" PRIu64 ",\"decisions\":%" PRIu64 ",\"rnd_decisions\":%" PRIu64 ","
+                 "\"propagations\":%" PRIu64 ",\"conflict_literals\":%" PRIu64 ",\"deleted_literals\":%" PRIu64 ",",
+            S.starts, S.conflicts, S.decisions, S.rnd_decisions, S.propagations, S.tot_literals, S.max_literals - S.tot_literals);
+
+    fprintf(out, "\"phases\":{");
+    for (int p = 0; p < phase_Count; p++)
+        fprintf(out, "%s\"%s\":{\"time\":%.6f,\"calls\":%" PRIu64 "}", p == 0 ? "" : ",", phaseName(p), st.phase_time[p], st.phase_calls[p]);
+
+    fprintf(out, "},\"partitions\":[");
+    int nparts = st.part_props.size() > st.part_conflicts.size() ? st.part_props.size() : st.part_conflicts.size();
+    for (int p = 0, first = 1; p < nparts; p++){
+        uint64_t props = p < st.part_props.size()     ? st.part_props[p]     : 0;
+        uint64_t confs = p < st.part_conflicts.size() ? st.part_conflicts[p] : 0;
+        if (props == 0 && confs == 0) continue;
+        fprintf(out, "%s{\"part\":%d,\"propagations\":%" PRIu64 ",\"conflicts\":%" PRIu64 "}", first ? "" : ",", p, props, confs);
+        first = 0; }
+
+    fprintf(out, "],\"gc\":{\"runs\":%" PRIu64 ",\"bytes_reclaimed\":%" PRIu64 "},"
+                 "\"proof\":{\"steps\":%" PRIu64 ",\"lemmas\":%" PRIu64 ",\"core_lemmas\":%" PRIu64 "}}\n",
+            st.gc_runs, st.gc_bytes, st.proof_steps, st.proof_lemmas, st.core_lemmas);
+    fclose(out);
+}
+
+
+//=================================================================================================
+// Writes the proof of an UNSAT answer in trace-check format:
+
+static void writeTrace(Solver& S, const char* file, bool binary, bool compress)
+{
+    if (compress){
+        gzFile out = gzopen(file, "wb");
+        if (out == NULL){ fprintf(stderr, "ERROR! Could not open file: %s\n", file); return; }
+        { TraceWriter w(out, binary); TraceProofVisitor v(S, w); S.replay(v); }
+        gzclose(out);
+    }else{
+        FILE* out = fopen(file, binary ? "wb" : "w");
+        if (out == NULL){ fprintf(stderr, "ERROR! Could not open file: %s\n", file); return; }
+        { TraceWriter w(out, binary); TraceProofVisitor v(S, w); S.replay(v); }
+        fclose(out);
+    }
+}
+
 //=================================================================================================
 // Main:
 
@@ -91,6 +150,12 @@ int main(int argc, char** argv)
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
         StringOption tcpf ("MAIN", "tcpf", "If given, write proof in trace-check format to this file");
+        BoolOption   tcpf_bin ("MAIN", "tcpf-bin", "Write the trace-check proof in binary (LRAT-style) encoding.", false);
+        BoolOption   tcpf_gz  ("MAIN", "tcpf-gz", "Compress the trace-check proof with gzip.", false);
+        IntOption    parse_threads("MAIN", "parse-threads", "Map the input and split it into clauses with this many threads (0=read it as a stream).", 0, IntRange(0, 1024));
+        StringOption save_state("MAIN", "save-state", "If given, stop after preprocessing and write the solver state to this file.");
+        StringOption load_state("MAIN", "load-state", "If given, take the solver state from this file (see -save-state) instead of reading the input.");
+        StringOption stats_json("MAIN", "stats-json", "If given, write the statistics to this file as JSON when done.");
         parseOptions(argc, argv, true);
         
         SimpSolver  S;
@@ -127,19 +192,25 @@ int main(int argc, char** argv)
                     printf("WARNING! Could not set resource limit: Virtual memory.\n");
             } }
         
-        if (argc == 1)
+        if (argc == 1 && !load_state)
             printf("Reading from standard input... Use '--help' for help.\n");
 
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
+        gzFile in = NULL;
+        if (!load_state && parse_threads == 0 && (in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb")) == NULL)
             printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
         
         if (S.verbosity > 0){
             printf("============================[ Problem Statistics ]=============================\n");
             printf("|                                                                             |\n"); }
         
-        parse_DIMACS(in, S);
-        gzclose(in);
+        if (load_state){
+            if (!S.loadState(load_state))
+                printf("ERROR! Could not load solver state: %s\n", (const char*)load_state), exit(1);
+        }else if (in != NULL){
+            parse_DIMACS(in, S);
+            gzclose(in);
+        }else if (!parse_DIMACS(argc == 1 ? NULL : argv[1], S, parse_threads))
+            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
         FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
 
         if (S.verbosity > 0){
@@ -171,12 +242,9 @@ int main(int argc, char** argv)
             printf("UNSATISFIABLE\n");
             if (S.proofLogging ()) printf ("%s\n", S.validate () ? "VALID" : "INVALID");
             if (S.proofLogging () && tcpf)
-            {
-              FILE *f = fopen ((const char*) tcpf, "w");
-              TraceProofVisitor v(S, f);
-              S.replay (v);
-              fclose (f);
-            }
+              writeTrace(S, tcpf, tcpf_bin, tcpf_gz);
+            if (stats_json)
+                writeStatsJSON(S, stats_json, "UNSAT");
             
             exit(20);
         }
@@ -190,6 +258,14 @@ int main(int argc, char** argv)
             exit(0);
         }
 
+        if (save_state){
+            if (!S.saveState(save_state))
+                printf("ERROR! Could not save solver state: %s\n", (const char*)save_state), exit(1);
+            if (S.verbosity > 0)
+                printStats(S);
+            exit(0);
+        }
+
         vec<Lit> dummy;
         lbool ret = S.solveLimited(dummy);
         
@@ -199,12 +275,9 @@ int main(int argc, char** argv)
         printf(ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
         if (ret == l_False && S.proofLogging ()) printf ("%s\n", S.validate () ? "VALID" : "INVALID");
         if (ret == l_False && S.proofLogging () && tcpf)
-        {
-          FILE *f = fopen ((const char*) tcpf, "w");
-          TraceProofVisitor v(S, f);
-          S.replay (v);
-          fclose (f);
-        }
+          writeTrace(S, tcpf, tcpf_bin, tcpf_gz);
+        if (stats_json)
+            writeStatsJSON(S, stats_json, ret == l_True ? "SAT" : ret == l_False ? "UNSAT" : "INDET");
         
         if (res != NULL){
             if (ret == l_True){
@@ -20,8 +20,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "mtl/Sort.h"
 #include "simp/SimpSolver.h"
+#include "core/StateFile.h"
 #include "utils/System.h"
 
+#include <thread>
+#include <vector>
+
 using namespace Minisat;
 
 //=================================================================================================
@@ -36,6 +40,7 @@ static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variabl
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
+static IntOption    opt_subsumption_threads(_cat, "sub-threads", "Number of threads that search the occurrence lists for backward subsumption.", 1, IntRange(1, 1024));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
 
 
@@ -51,11 +56,13 @@ SimpSolver::SimpSolver() :
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , subsumption_threads(opt_subsumption_threads)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
   , elimorder          (1)
   , use_simplification (true)
+  , proofLoc           (UINT32_MAX)
   , occurs             (ClauseDeleted(ca))
   , elim_heap          (ElimLt(n_occ))
   , bwdsub_assigns     (0)
@@ -78,6 +85,7 @@ Var SimpSolver::newVar(bool sign, bool dvar) {
 
     frozen    .push((char)false);
     eliminated.push((char)false);
+    var_part  .push(Range());
 
     if (use_simplification){
         n_occ     .push(0);
@@ -134,11 +142,23 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
 
 bool SimpSolver::addClause_(vec<Lit>& ps, Range part)
 {
+    cancelUntil(0);
+
 #ifndef NDEBUG
     for (int i = 0; i < ps.size(); i++)
         assert(!isEliminated(var(ps[i])));
 #endif
 
+    // -- a variable shared between partitions is part of the interface of the
+    // -- interpolants and must survive preprocessing
+    if (proofLogging ())
+        for (int i = 0; i < ps.size(); i++){
+            Var v = var(ps[i]);
+            var_part[v].join (part);
+            if (!frozen[v] && !var_part[v].singleton ())
+                setFrozen(v, true);
+        }
+
     int nclauses = clauses.size();
 
     if (use_rcheck && implied(ps))
@@ -315,15 +335,12 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& ou
 
     for (int i = 0; i < qs.size(); i++){
         if (var(qs[i]) != v){
-            for (int j = 0; j < ps.size(); j++)
-                if (var(ps[j]) == var(qs[i]))
-                    if (ps[j] == ~qs[i])
-                        return false;
-                    else
-                        goto next;
-            out_clause.push(qs[i]);
+            int j = findVar(ps, ps.size(), var(qs[i]));
+            if (j == ps.size())
+                out_clause.push(qs[i]);
+            else if (ps[j] == ~qs[i])
+                return false;
         }
-        next:;
     }
 
     for (int i = 0; i < ps.size(); i++)
@@ -349,15 +366,12 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
 
     for (int i = 0; i < qs.size(); i++){
         if (var(__qs[i]) != v){
-            for (int j = 0; j < ps.size(); j++)
-                if (var(__ps[j]) == var(__qs[i]))
-                    if (__ps[j] == ~__qs[i])
-                        return false;
-                    else
-                        goto next;
-            size++;
+            int j = findVar(__ps, ps.size(), var(__qs[i]));
+            if (j == ps.size())
+                size++;
+            else if (__ps[j] == ~__qs[i])
+                return false;
         }
-        next:;
     }
 
     return true;
@@ -420,6 +434,8 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
     int deleted_literals = 0;
     assert(decisionLevel() == 0);
 
+    SubsumptionTable ahead;
+
     while (subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()){
 
         // Empty subsumption queue and return immediately on user-interrupt:
@@ -435,9 +451,18 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
             ca[bwdsub_tmpunit].calcAbstraction();
             subsumption_queue.insert(bwdsub_tmpunit); }
 
+        // Search the occurrence lists for the queue in parallel, small queues are not worth it:
+        if (subsumption_threads > 1 && ahead.done() && subsumption_queue.size() >= 1024)
+            searchSubsumed(ahead);
+
         CRef    cr = subsumption_queue.peek(); subsumption_queue.pop();
         Clause& c  = ca[cr];
 
+        // The results of the search hold for the pairs of clauses that did not change since:
+        int  k     = ahead.done() ? -1 : ahead.next++;
+        bool found = k >= 0 && ahead.owner[k] >= 0 && ahead.same(cr);
+        assert(k < 0 || ahead.queue[k] == cr);
+
         if (c.mark()) continue;
 
         if (verbose && verbosity >= 2 && cnt++ % 1000 == 0)
@@ -451,6 +476,14 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
             if (occurs[var(c[i])].size() < occurs[best].size())
                 best = var(c[i]);
 
+        // While nothing was propagated since the search, and the hits are as they were, the other
+        // candidates are left alone by the loop below and it only has to stop at the hits.
+        // Strengthening a clause never turns it into a hit:
+        bool skip = found && best == ahead.best[k] && !ahead.stale;
+        for (int i = 0; skip && i < ahead.count[k]; i++)
+            skip = ahead.same(ahead.hitClause(k, i));
+        int  h = 0;
+
         // Search all candidates:
         vec<CRef>& _cs = occurs.lookup(best);
         CRef*       cs = (CRef*)_cs;
@@ -460,7 +493,15 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
           Clause &c = ca[cr];
           if (c.mark())
             break;
-          else if (!ca[cs[j]].mark() &&  cs[j] != cr && (subsumption_lim == -1 || ca[cs[j]].size() < subsumption_lim)){
+
+          if (skip && trail.size() == ahead.trail){
+            while (h < ahead.count[k] && ca[ahead.hitClause(k, h)].mark()) h++;
+            if (h == ahead.count[k]) break;
+            if (cs[j] != ahead.hitClause(k, h)) continue;
+            h++;
+          }
+
+          if (!ca[cs[j]].mark() &&  cs[j] != cr && (subsumption_lim == -1 || ca[cs[j]].size() < subsumption_lim)){
             
             if (satisfied (ca[cs[j]]))
             {
@@ -468,7 +509,7 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
               continue;
             }
             
-            Lit l = c.subsumes(ca[cs[j]]);
+            Lit l = found && ahead.same(cs[j]) ? ahead.hit(k, cs[j]) : c.subsumes(ca[cs[j]]);
 
             if (l == lit_Undef)
               subsumed++, removeClause(cs[j]);
@@ -476,12 +517,19 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
               deleted_literals++;
               
               CRef csj = cs[j];
+              // -- a clause that was too large for the search may not be any more
+              if (subsumption_lim != -1 && ca[csj].size() >= subsumption_lim)
+                ahead.stale = true;
               // AG: the result of strengthenClause is a new clause that replaced cs[j]
               // AG: partition of new clause is cs[j].part ().join (c.part ())
               if (!strengthenClause(csj, ~l))
                 return false;
+              if (ahead.queue.size() > 0 && ahead.same(csj))
+                ahead.changed.insert(csj, 1);
 
-              if (proofLogging ()) ca [csj].part ().join (ca[cr].part ());
+              // AG: the temporary unit has no partition, use the one of the level-0 unit
+              if (proofLogging ())
+                joinPart (csj, cr == bwdsub_tmpunit ? trail_part [var (ca[cr][0])] : ca[cr].part ());
                     
 
               // Did current candidate get deleted from cs? Then check candidate at index j again:
@@ -497,6 +545,82 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 }
 
 
+// Searches the occurrence lists for the clauses that the entries of the subsumption queue subsume or
+// strengthen, with 'subsumption_threads' threads. Each entry goes to the thread of the variable whose
+// occurrence list is searched. A clause that an entry subsumes or strengthens contains all its
+// variables, so the results stay complete while the sequential pass picks other lists, and the
+// pass finds the same clauses as without the search.
+void SimpSolver::searchSubsumed(SubsumptionTable& t)
+{
+    int n = subsumption_queue.size();
+    t.queue.clear();
+    t.best .clear();
+    for (int k = 0; k < n; k++){
+        CRef          cr   = subsumption_queue[k];
+        const Clause& c    = ca[cr];
+        Var           best = var_Undef;
+        if (cr != bwdsub_tmpunit && !c.mark()){
+            best = var(c[0]);
+            for (int i = 1; i < c.size(); i++)
+                if (occurs[var(c[i])].size() < occurs[best].size())
+                    best = var(c[i]);
+        }
+        t.queue.push(cr);
+        t.best .push(best);
+    }
+
+    t.owner.clear(); t.owner.growTo(n, -1);
+    t.first.clear(); t.first.growTo(n, 0);
+    t.count.clear(); t.count.growTo(n, 0);
+    t.cand .clear(); t.cand .growTo(subsumption_threads);
+    t.lit  .clear(); t.lit  .growTo(subsumption_threads);
+    t.changed.clear();
+    t.fresh = ca.size();
+    t.trail = trail.size();
+    t.stale = false;
+    t.next  = 0;
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < subsumption_threads; i++)
+        threads.push_back(std::thread(&SimpSolver::findSubsumed, this, &t, i));
+    findSubsumed(&t, 0);
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+}
+
+
+// Searches the entries of 't' that belong to thread 'id'. Only reads the clause database.
+void SimpSolver::findSubsumed(SubsumptionTable* t, int id)
+{
+    vec<CRef>& cand = t->cand[id];
+    vec<Lit>&  lit  = t->lit [id];
+
+    for (int k = 0; k < t->queue.size(); k++){
+        Var best = t->best[k];
+        if (best == var_Undef || best % subsumption_threads != id) continue;
+
+        CRef             cr = t->queue[k];
+        const Clause&    c  = ca[cr];
+        const vec<CRef>& cs = occurs[best];
+        t->owner[k] = id;
+        t->first[k] = cand.size();
+        for (int j = 0; j < cs.size(); j++){
+            const Clause& d = ca[cs[j]];
+            if (cs[j] == cr || d.mark() || (subsumption_lim != -1 && d.size() >= subsumption_lim))
+                continue;
+
+            // -- 'subsumes()' rejects most candidates by their abstractions
+            if (satisfied(d))
+                cand.push(cs[j]), lit.push(lit_Error);
+            else{
+                Lit l = c.subsumes(d);
+                if (l != lit_Error)
+                    cand.push(cs[j]), lit.push(l); }
+        }
+        t->count[k] = cand.size() - t->first[k];
+    }
+}
+
+
 bool SimpSolver::asymm(Var v, CRef cr)
 {
     Clause& c = ca[cr];
@@ -514,6 +638,8 @@ bool SimpSolver::asymm(Var v, CRef cr)
     trail_lim.push (trail.size ());
     CRef confl = propagate ();
     if (confl != CRef_Undef){
+        Range part;
+        if (proofLogging ()) part = conflictPart (confl);
         cancelUntil(1);
         Clause &conflC = ca[confl];
         bool allFalse = false;
@@ -530,19 +656,10 @@ bool SimpSolver::asymm(Var v, CRef cr)
         asymm_lits++;
         /// AG: the result of strengthenClause is the new clause added to the proof
         /// AG: the new clause does not replace anything
-        /// AG: partition of the new clause depends on analyzing propagate
-        /// AG: simple solution is to set partition of new clause to the widest range
-        /// AG: and let interpolation/validation figure out how the clause was derived
+        /// AG: partition of the new clause is the join of the clauses used by propagate
         if (!strengthenClause(cr, l))
             return false;
-        if (proofLogging ())
-        {
-          ca [cr].part ().join (totalPart);
-          /* 
-          ca [cr].part ().join (1);
-          ca [cr].part ().join (currentPart);
-          */
-        }
+        if (proofLogging ()) joinPart (cr, part);
     }else
         cancelUntil(0);
 
@@ -550,6 +667,8 @@ bool SimpSolver::asymm(Var v, CRef cr)
 }
 
 
+// Partition of the clauses that propagate used to derive the conflict 'confl' above level 0,
+// including the level-0 units they depend on.
 bool SimpSolver::asymmVar(Var v)
 {
     assert(use_simplification);
@@ -651,14 +770,19 @@ bool SimpSolver::eliminateVar(Var v)
           int nclauses = clauses.size ();
           // merged clause is join of partitions of pos[i] and neg[j]
           // AG: partition of the resolvent is join of partitions of pos[i] and neg[j]
-          if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && 
-              !addClause_(resolvent, part))
-                return false;
+          if (!merge(ca[pos[i]], ca[neg[j]], v, resolvent)) continue;
+          bool ok_res = addClause_(resolvent, part);
           if (proofLogging () && clauses.size () == nclauses + 1)
           {
             proof.push (clauses.last ());
-            proofLoc.insert (clauses.last (), proof.size () - 1);
+            // -- a unit resolvent that propagated to a conflict goes before it
+            if (!ok_res){
+              proof [proof.size () - 1] = proof [proof.size () - 2];
+              proof [proof.size () - 2] = clauses.last ();
+            }
+            proofLoc.insert (clauses.last (), proof.size () - (ok_res ? 1 : 2));
           }
+          if (!ok_res) return false;
         }
     
     for (int i = 0; i < cls.size(); i++)
@@ -731,6 +855,7 @@ void SimpSolver::extendModel()
 
 bool SimpSolver::eliminate(bool turn_off_elim)
 {
+    PhaseTimer timer(stat, phase_Eliminate);
     if (!simplify())
         return false;
     else if (!use_simplification)
@@ -853,8 +978,24 @@ void SimpSolver::relocAll(ClauseAllocator& to)
 }
 
 
+// Re-keys 'proofLoc' after 'relocAll()' and looks up the positions again, the proof may have
+// been trimmed (see 'Solver::trimProof()'). A clause is located at its first step.
+void SimpSolver::relocProofLoc()
+{
+    if (proofLoc.size() == 0) return;
+
+    proofLoc.relocate(ClauseRelocated(ca));
+    RefTable<CRef, unsigned> loc(UINT32_MAX);
+    for (int i = 0; i < proof.size(); i++)
+        if (proofLoc.has(proof[i]) && !loc.has(proof[i]))
+            loc.insert(proof[i], i);
+    loc.moveTo(proofLoc);
+}
+
+
 void SimpSolver::garbageCollect()
 {
+    PhaseTimer timer(stat, phase_GC);
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted()); 
@@ -863,8 +1004,37 @@ void SimpSolver::garbageCollect()
     to.extra_clause_field = ca.extra_clause_field; // NOTE: this is important to keep (or lose) the extra fields.
     relocAll(to);
     Solver::relocAll(to);
+    relocProofLoc();
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n", 
+               (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
+    stat.collected((uint64_t)(ca.size() - to.size())*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
+
+
+// Only the state that outlives 'eliminate(true)' is written, a solver that still simplifies can not
+// be saved:
+void SimpSolver::writeState(StateFile& f)
+{
+    if (use_simplification){
+        f.ok = false;
+        return; }
+
+    Solver::writeState(f);
+    f.put(elimclauses);
+    f.put(frozen);
+    f.put(eliminated);
+    f.put(var_part);
+}
+
+
+void SimpSolver::readState(StateFile& f)
+{
+    Solver::readState(f);
+    f.get(elimclauses);
+    f.get(frozen);
+    f.get(eliminated);
+    f.get(var_part);
+    use_simplification = false;
+}
@@ -90,6 +90,7 @@ class SimpSolver : public Solver {
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    int     subsumption_threads; // Number of threads that search the occurrence lists for backward subsumption.
 
     // Statistics:
     //
@@ -117,6 +118,35 @@ class SimpSolver : public Solver {
         //     return c_x < c_y || c_x == c_y && x < y; }
     };
 
+    // Results of the search for backward subsumption that the threads do ahead of the sequential
+    // pass. An entry of the queue is searched by the thread of its occurrence list, and the pass
+    // uses the results as long as neither clause of a pair changed since:
+    //
+    struct SubsumptionTable {
+        vec<CRef>       queue;   // The entries at the head of 'subsumption_queue' that were searched.
+        vec<Var>        best;    // Variable of the occurrence list that was searched for each entry.
+        vec<int>        owner;   // Thread that searched each entry, -1 if it was not searched.
+        vec<int>        first;   // Offset of the hits of each entry in 'cand' and 'lit' of its owner.
+        vec<int>        count;   // Number of hits of each entry.
+        vec<vec<CRef> > cand;    // Clauses that the entry subsumes or strengthens, or that are satisfied.
+        vec<vec<Lit> >  lit;     // Result of 'Clause::subsumes()' for each of them, 'lit_Error' if satisfied.
+        CRef            fresh;   // Clauses from this reference on were allocated after the search.
+        CMap<char>      changed; // Clauses that were strengthened after the search.
+        int             trail;   // Size of the trail at the search.
+        bool            stale;   // A clause may have become a candidate that the search left out.
+        int             next;    // Next entry of 'queue' to be popped by the pass.
+
+        SubsumptionTable() : fresh(0), trail(0), stale(false), next(0) {}
+        bool done() const { return next == queue.size(); }
+        bool same(CRef cr) { char dummy; return cr < fresh && (changed.size() == 0 || !changed.has(cr, dummy)); }
+        CRef hitClause(int k, int i) const { return cand[owner[k]][first[k] + i]; }
+        Lit  hit (int k, CRef cr) const {
+            const vec<CRef>& cs = cand[owner[k]];
+            for (int i = first[k]; i < first[k] + count[k]; i++)
+                if (cs[i] == cr) return lit[owner[k]][i];
+            return lit_Error; }
+    };
+
     struct ClauseDeleted {
         const ClauseAllocator& ca;
         explicit ClauseDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
@@ -135,12 +165,13 @@ class SimpSolver : public Solver {
     Queue<CRef>         subsumption_queue;
     vec<char>           frozen;
     vec<char>           eliminated;
+    vec<Range>          var_part;         // Partitions of the added clauses a variable occurs in (proof logging).
     int                 bwdsub_assigns;
     int                 n_touched;
   
   // -- proof logging related
   // -- maps a cref to its location in the clausal proof
-  CMap<unsigned> proofLoc;
+  RefTable<CRef, unsigned> proofLoc;
 
     // Temporaries:
     //
@@ -156,6 +187,8 @@ class SimpSolver : public Solver {
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause);
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
+    void          searchSubsumed           (SubsumptionTable& t);
+    void          findSubsumed             (SubsumptionTable* t, int id);
     bool          eliminateVar             (Var v);
     void          extendModel              ();
 
@@ -164,6 +197,9 @@ class SimpSolver : public Solver {
     void          cleanUpClauses           ();
     bool          implied                  (const vec<Lit>& c);
     void          relocAll                 (ClauseAllocator& to);
+    void          relocProofLoc            ();
+    void          writeState               (StateFile& f);
+    void          readState                (StateFile& f);
 };
 
 
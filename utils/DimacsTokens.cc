@@ -0,0 +1,188 @@
+#include "utils/DimacsTokens.h"
+#include "mtl/XAlloc.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <thread>
+#include <vector>
+
+using namespace Minisat;
+
+// The part of the input that one thread splits into tokens, and what it found there:
+struct DimacsTokens::Chunk {
+    const char* begin;
+    const char* end;
+    vec<int>*   tokens;
+    int         max_var;
+    int         clauses;
+    uint64_t    literals;
+    bool        header;
+    int         header_vars;
+    int         header_clauses;
+    const char* error;          // Position of the first unexpected character, or NULL.
+
+    Chunk() : begin(NULL), end(NULL), tokens(NULL), max_var(0), clauses(0), literals(0),
+              header(false), header_vars(0), header_clauses(0), error(NULL) {}
+};
+
+
+DimacsTokens::DimacsTokens() :
+    header(false), header_vars(0), header_clauses(0),
+    data(NULL), size(0), cap(0), mapped(false), max_var(0), nclauses(0), nliterals(0)
+{}
+
+
+DimacsTokens::~DimacsTokens()
+{
+    if (data == NULL) return;
+    if (mapped) munmap((void*)data, cap);
+    else        xunmap((void*)data, cap);
+}
+
+
+bool DimacsTokens::load(const char* file)
+{
+    // -- a plain file is mapped, unless it starts like a gzip stream
+    if (file != NULL){
+        int fd = open(file, O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat   st;
+        unsigned char magic[2] = { 0, 0 };
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+            pread(fd, magic, 2, 0) >= 0 && !(magic[0] == 0x1f && magic[1] == 0x8b)){
+            void* mem = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mem != MAP_FAILED){
+                madvise(mem, st.st_size, MADV_WILLNEED);
+                close(fd);
+                data   = (const char*)mem;
+                size   = cap = st.st_size;
+                mapped = true;
+                return true; } }
+        close(fd);
+    }
+
+    // -- anything else goes through zlib, the buffer grows by remapping its pages
+    gzFile in = file == NULL ? gzdopen(0, "rb") : gzopen(file, "rb");
+    if (in == NULL) return false;
+
+    const size_t block = (size_t)1 << 24;
+    char*        buf   = NULL;
+    for (;;){
+        if (cap - size < block){
+            size_t new_cap = cap * 2 + block;
+            buf = (char*)xmremap(buf, cap, new_cap);
+            cap = new_cap; }
+        int n = gzread(in, buf + size, block);
+        if (n <= 0) break;
+        size += n;
+    }
+    gzclose(in);
+    data = buf;
+    return true;
+}
+
+
+void DimacsTokens::scan(Chunk* c)
+{
+    const char* p = c->begin;
+    const char* e = c->end;
+    vec<int>&   t = *c->tokens;
+
+    while (p < e){
+        int ch = (unsigned char)*p;
+        if ((ch >= 9 && ch <= 13) || ch == 32){
+            p++;
+            continue; }
+
+        // -- comments and the header are whole lines, and chunks are cut at line starts
+        if (ch == 'c'){
+            const char* eol = (const char*)memchr(p, '\n', e - p);
+            if (eol == NULL) eol = e;
+            if (eol - p >= 11 && memcmp(p, "c partition", 11) == 0)
+                t.push(PartMark);
+            p = eol;
+            continue; }
+
+        if (ch == 'p'){
+            if (e - p < 5 || memcmp(p, "p cnf", 5) != 0){
+                c->error = p;
+                return; }
+            p += 5;
+            int* field[2] = { &c->header_vars, &c->header_clauses };
+            for (int i = 0; i < 2; i++){
+                while (p < e && (*p == ' ' || *p == '\t')) p++;
+                if (p == e || *p < '0' || *p > '9'){
+                    c->error = p;
+                    return; }
+                int val = 0;
+                while (p < e && *p >= '0' && *p <= '9') val = val*10 + (*p++ - '0');
+                *field[i] = val; }
+            c->header = true;
+            continue; }
+
+        bool neg = false;
+        if      (ch == '-') neg = true, p++;
+        else if (ch == '+') p++;
+        if (p == e || *p < '0' || *p > '9'){
+            c->error = p;
+            return; }
+        int val = 0;
+        while (p < e && *p >= '0' && *p <= '9') val = val*10 + (*p++ - '0');
+
+        if (val == 0) c->clauses++;
+        else{
+            c->literals++;
+            if (val > c->max_var) c->max_var = val; }
+        t.push(neg ? -val : val);
+    }
+}
+
+
+void DimacsTokens::tokenize(int nthreads)
+{
+    // -- cut the input at the first line start after every 'size/nthreads' bytes
+    std::vector<Chunk> cs(nthreads);
+    tokens.clear();
+    tokens.growTo(nthreads);
+    const char* end = data + size;
+    const char* p   = data;
+    for (int i = 0; i < nthreads; i++){
+        cs[i].begin  = p;
+        if (i + 1 < nthreads){
+            p = data + size / nthreads * (i + 1);
+            if (p < cs[i].begin) p = cs[i].begin;
+            const char* eol = (const char*)memchr(p, '\n', end - p);
+            p = eol == NULL ? end : eol + 1;
+        }else
+            p = end;
+        cs[i].end    = p;
+        cs[i].tokens = &tokens[i];
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nthreads; i++)
+        threads.push_back(std::thread(scan, &cs[i]));
+    scan(&cs[0]);
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+    for (int i = 0; i < nthreads; i++){
+        if (cs[i].error != NULL){
+            int ch = cs[i].error == end ? EOF : *cs[i].error;
+            fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", ch), exit(3); }
+        if (cs[i].max_var > max_var) max_var = cs[i].max_var;
+        nclauses  += cs[i].clauses;
+        nliterals += cs[i].literals;
+        if (cs[i].header && !header){
+            header         = true;
+            header_vars    = cs[i].header_vars;
+            header_clauses = cs[i].header_clauses; }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef Minisat_DimacsTokens_h
+#define Minisat_DimacsTokens_h
+
+#include <stddef.h>
+
+#include "mtl/IntTypes.h"
+#include "mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// DimacsTokens -- a DIMACS file in memory, split into the numbers of its clauses by several threads:
+//
+// A plain file is mapped, other input is decompressed into memory. The input is cut into one chunk
+// per thread at line starts, so that a chunk may begin or end in the middle of a clause, but
+// reading the tokens of the chunks in order gives the clauses in the order of the file.
+
+
+class DimacsTokens {
+ public:
+    enum { PartMark = INT32_MIN };  // Token of a "c partition" line, the clauses after it go to the next partition.
+
+    DimacsTokens();
+    ~DimacsTokens();
+
+    bool     load      (const char* file);  // Read 'file' into memory (standard input if NULL). False if it can not be opened.
+    void     tokenize  (int nthreads);      // Split the input into tokens, exits with a parse error like 'parse_DIMACS()'.
+
+    int             chunks  ()      const { return tokens.size(); }
+    const vec<int>& chunk   (int i) const { return tokens[i]; } // Literals as in the file, 0 after each clause, and 'PartMark'.
+    int             maxVar  ()      const { return max_var; }   // Largest variable that occurs in a clause (counted from 1).
+    int             clauses ()      const { return nclauses; }
+    uint64_t        literals()      const { return nliterals; }
+
+    bool            header;         // Was there a "p cnf" line?
+    int             header_vars;    // Its number of variables.
+    int             header_clauses; // Its number of clauses.
+
+ private:
+    struct Chunk;
+
+    const char*     data;
+    size_t          size;
+    size_t          cap;
+    bool            mapped;         // 'data' is a mapping of the file rather than memory of 'xmremap()'.
+    vec<vec<int> >  tokens;
+    int             max_var;
+    int             nclauses;
+    uint64_t        nliterals;
+
+    static void     scan(Chunk* c);
+
+    // Not copyable:
+    DimacsTokens(const DimacsTokens&);
+    DimacsTokens& operator=(const DimacsTokens&);
+};
+
+//=================================================================================================
+}
+
+#endif